@@ -21,7 +21,7 @@
 //
 // ============================================================
 //
-// aids — 0.17.0 — std replacement for C++. Designed to aid developers
+// aids — 0.19.0 — std replacement for C++. Designed to aid developers
 // to a better programming experience.
 //
 // https://github.com/rexim/aids
@@ -30,6 +30,14 @@
 //
 // ChangeLog (https://semver.org/ is implied)
 //
+//   0.19.0 Dynamic_Array::reserve()
+//          Dynamic_Array::grow()
+//          Dynamic_Array::pop()
+//          Dynamic_Array::clear()
+//          Dynamic_Array::release()
+//          Fix Dynamic_Array::concat() not growing for all of the items
+//   0.18.0 Arena
+//          String_Buffer arena_string_buffer(Arena *arena, size_t capacity)
 //   0.17.0 Dynamic_Array::concat()
 //          Dynamic_Array::expand_capacity()
 //   0.16.0 Dynamic_Array
@@ -81,6 +89,7 @@
 #include <cassert>
 #include <cctype>
 #include <cerrno>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
@@ -434,10 +443,46 @@ namespace aids
         return {true, {static_cast<size_t>(size), static_cast<const char*>(data)}};
     }
 
+    ////////////////////////////////////////////////////////////
+    // ARENA
+    ////////////////////////////////////////////////////////////
+
+    // Linear allocator over a fixed chunk of memory provided by the
+    // user. Nothing is freed individually: take a mark() before
+    // allocating transient data and reset() back to it when done.
+    struct Arena
+    {
+        size_t capacity;
+        char *data;
+        size_t size;
+
+        void *alloc(size_t n, size_t alignment = alignof(max_align_t))
+        {
+            assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+            const size_t begin = (size + alignment - 1) & ~(alignment - 1);
+            assert(begin + n <= capacity && "Arena overflow");
+            size = begin + n;
+            return data + begin;
+        }
+
+        size_t mark() const
+        {
+            return size;
+        }
+
+        void reset(size_t mark = 0)
+        {
+            assert(mark <= size);
+            size = mark;
+        }
+    };
+
     ////////////////////////////////////////////////////////////
     // DYNAMIC ARRAY
     ////////////////////////////////////////////////////////////
 
+    const size_t DYNAMIC_ARRAY_INITIAL_CAPACITY = 256;
+
     template <typename T>
     struct Dynamic_Array
     {
@@ -445,32 +490,69 @@ namespace aids
         size_t size;
         T *data;
 
-        void expand_capacity()
+        // Makes the capacity at least `new_capacity`. Never shrinks.
+        void reserve(size_t new_capacity)
         {
-            capacity = data ? 2 * capacity : 256;
-            data = (T*)realloc((void*)data, capacity * sizeof(T));
+            if (new_capacity <= capacity) return;
+
+            data = (T*)realloc((void*)data, new_capacity * sizeof(T));
+            capacity = new_capacity;
         }
 
-        void push(T item)
+        // Amortised growth: the capacity is doubled until `required`
+        // items fit.
+        void grow(size_t required)
         {
-            while (size + 1 > capacity) {
-                expand_capacity();
+            if (required <= capacity) return;
+
+            size_t new_capacity = capacity > 0 ? capacity : DYNAMIC_ARRAY_INITIAL_CAPACITY;
+            while (new_capacity < required) {
+                new_capacity *= 2;
             }
 
-            memcpy(data + size, &item, sizeof(T));
-            size += 1;
+            reserve(new_capacity);
         }
 
-        void concat(const T *items, size_t items_count)
+        void expand_capacity()
         {
-            while (size + 1 > capacity) {
-                expand_capacity();
-            }
+            grow(capacity + 1);
+        }
 
-            memcpy(data + size, items, sizeof(T) * items_count);
+        void push(T item)
+        {
+            grow(size + 1);
+            data[size++] = item;
+        }
+
+        void concat(const T *items, size_t items_count)
+        {
+            grow(size + items_count);
+            memcpy((void*)(data + size), (const void*)items, sizeof(T) * items_count);
             size += items_count;
         }
 
+        T pop()
+        {
+            assert(size > 0);
+            size -= 1;
+            return data[size];
+        }
+
+        // Keeps the storage so the array can be refilled without
+        // allocating.
+        void clear()
+        {
+            size = 0;
+        }
+
+        void release()
+        {
+            free(data);
+            data = nullptr;
+            capacity = 0;
+            size = 0;
+        }
+
         bool contains(T item)
         {
             for (size_t i = 0; i < size; ++i) {
@@ -560,6 +642,17 @@ namespace aids
         }
     };
 
+    String_Buffer arena_string_buffer(Arena *arena, size_t capacity)
+    {
+        assert(capacity > 0);
+        String_Buffer result = {};
+        result.capacity = capacity;
+        result.data = (char*)arena->alloc(capacity, 1);
+        result.size = 0;
+        result.data[0] = '\0';
+        return result;
+    }
+
     void sprint1(String_Buffer *buffer, const char *cstr)
     {
         int n = snprintf(
@@ -0,0 +1,72 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+
+#include "./aids.hpp"
+
+using namespace aids;
+
+#include "./something_level_archive.cpp"
+
+// NOTE: must be kept in sync with ROOM_WIDTH and ROOM_HEIGHT from
+// something_tile_grid.hpp. The game refuses archives with different
+// room dimensions.
+const uint16_t PACKER_ROOM_WIDTH = 10 * 2;
+const uint16_t PACKER_ROOM_HEIGHT = 10 * 2;
+const size_t PACKER_ROOM_TILES_COUNT = PACKER_ROOM_WIDTH * PACKER_ROOM_HEIGHT;
+
+// NOTE: raw room files store every tile as uint32_t
+using Raw_Tile = uint32_t;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        println(stderr, "Usage: ./level_packer <output.pack> <room.bin>...");
+        exit(1);
+    }
+
+    const char *output_filepath = argv[1];
+    const size_t rooms_count = (size_t) (argc - 2);
+
+    Dynamic_Array<uint8_t> rooms = {};
+    rooms.reserve(rooms_count * PACKER_ROOM_TILES_COUNT);
+
+    for (int i = 2; i < argc; ++i) {
+        FILE *f = fopen(argv[i], "rb");
+        if (f == NULL) {
+            println(stderr, "Could not open file `", argv[i], "`: ", strerror(errno));
+            exit(1);
+        }
+
+        Raw_Tile raw[PACKER_ROOM_TILES_COUNT] = {};
+        const size_t n = fread(raw, sizeof(raw[0]), PACKER_ROOM_TILES_COUNT, f);
+        fclose(f);
+
+        if (n != PACKER_ROOM_TILES_COUNT) {
+            println(stderr, "`", argv[i], "` is not a ", (int) PACKER_ROOM_WIDTH, "x", (int) PACKER_ROOM_HEIGHT, " room");
+            exit(1);
+        }
+
+        for (size_t j = 0; j < PACKER_ROOM_TILES_COUNT; ++j) {
+            if (raw[j] > UINT8_MAX) {
+                println(stderr, "`", argv[i], "` has a tile ", raw[j], " that does not fit into a byte");
+                exit(1);
+            }
+            rooms.push((uint8_t) raw[j]);
+        }
+    }
+
+    if (!save_level_archive(output_filepath,
+                            PACKER_ROOM_WIDTH, PACKER_ROOM_HEIGHT,
+                            rooms.data, rooms_count)) {
+        println(stderr, "Could not save `", output_filepath, "`: ", strerror(errno));
+        exit(1);
+    }
+
+    println(stdout, "Packed ", rooms_count, " rooms into `", output_filepath, "`");
+
+    return 0;
+}
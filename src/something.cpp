@@ -5,6 +5,11 @@
 #include <cmath>
 #include <SDL.h>
 
+// NOTE: the text and the render buffer draw with SDL_RenderGeometry()
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+#error "SDL 2.0.18 or newer is required"
+#endif
+
 #ifdef SOMETHING_RELEASE
 #define STB_IMAGE_IMPLEMENTATION
 #endif
@@ -41,15 +46,28 @@ using namespace aids;
 #else
 #include <dirent.h>
 #endif // _WIN32
+#if defined(__unix__) || defined(__APPLE__)
+#include "something_mapped_file_mmap.cpp"
+#else
+#include "something_mapped_file_stdio.cpp"
+#endif
+#include "something_level_archive.cpp"
 #include "something_error.cpp"
 #include "something_color.cpp"
 #include "something_render.cpp"
 #include "something_font.cpp"
 #include "something_camera.cpp"
+#ifndef SOMETHING_RELEASE
+#include "something_profiler.cpp"
+#else
+#include "something_profiler.hpp"
+#endif // SOMETHING_RELEASE
 #include "something_texture.cpp"
 #include "something_sprite.cpp"
 #include "something_tile_grid.cpp"
 #include "something_sound.cpp"
+#include "something_asset_cache.cpp"
+#include "something_asset_loader.cpp"
 #include "something_entity.cpp"
 #include "something_popup.cpp"
 #include "something_item.cpp"
@@ -60,5 +78,10 @@ using namespace aids;
 #include "something_console.cpp"
 #include "something_particles.cpp"
 #include "something_background.cpp"
+#include "something_room_index.cpp"
+#include "something_room_streamer.cpp"
+#include "something_room_lod.cpp"
 #include "something_game.cpp"
+#ifndef SOMETHING_BENCH
 #include "something_main.cpp"
+#endif // SOMETHING_BENCH
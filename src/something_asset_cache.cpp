@@ -0,0 +1,167 @@
+#include <sys/stat.h>
+
+#include "./something_asset_cache.hpp"
+
+bool Asset_Cache_Key::operator==(const Asset_Cache_Key &that) const
+{
+    return strncmp(source_path, that.source_path, ASSET_CACHE_PATH_CAPACITY) == 0
+        && source_size == that.source_size
+        && source_mtime == that.source_mtime
+        && source_hash == that.source_hash;
+}
+
+bool Asset_Cache::open(const char *filepath)
+{
+    auto mapped = map_file(filepath);
+    if (!mapped.has_value) return false;
+
+    file = mapped.unwrap;
+    is_open = true;
+
+    const auto fail = [&]() {
+        close();
+        return false;
+    };
+
+    if (file.size < sizeof(header)) return fail();
+    memcpy(&header, file.data, sizeof(header));
+
+    if (memcmp(header.magic, ASSET_CACHE_MAGIC, sizeof(ASSET_CACHE_MAGIC)) != 0) return fail();
+    if (header.version != ASSET_CACHE_VERSION) return fail();
+
+    const size_t entries_end = sizeof(header) + header.entries_count * sizeof(Asset_Cache_Entry);
+    if (file.size < entries_end) return fail();
+    entries = (const Asset_Cache_Entry *) (file.data + sizeof(header));
+
+    for (size_t i = 0; i < header.entries_count; ++i) {
+        const auto entry = &entries[i];
+        if (entry->offset < entries_end || entry->offset > file.size) return fail();
+        if (entry->size > file.size - entry->offset) return fail();
+
+        switch (entry->kind) {
+        case Asset_Cache_Kind::Pixels: {
+            if (entry->size != (uint64_t) entry->width * entry->height * sizeof(uint32_t)) return fail();
+        } break;
+
+        case Asset_Cache_Kind::Pcm_S16: {
+            if (entry->size % sizeof(int16_t) != 0) return fail();
+        } break;
+
+        default:
+            return fail();
+        }
+    }
+
+    return true;
+}
+
+void Asset_Cache::close()
+{
+    if (is_open) {
+        unmap_file(file);
+    }
+    is_open = false;
+    file = {};
+    header = {};
+    entries = nullptr;
+}
+
+const Asset_Cache_Entry *Asset_Cache::find(const Asset_Cache_Key *key, Asset_Cache_Kind kind) const
+{
+    if (!is_open) return nullptr;
+
+    for (size_t i = 0; i < header.entries_count; ++i) {
+        if (entries[i].kind == kind && entries[i].key == *key) {
+            return &entries[i];
+        }
+    }
+
+    return nullptr;
+}
+
+const void *Asset_Cache::payload(const Asset_Cache_Entry *entry) const
+{
+    assert(is_open);
+    return file.data + entry->offset;
+}
+
+// NOTE: FNV-1a
+static uint64_t asset_cache_hash(const char *data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ (uint8_t) data[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+Maybe<Asset_Cache_Key> asset_cache_key(const char *source_path)
+{
+    Asset_Cache_Key key = {};
+
+    if (strlen(source_path) >= ASSET_CACHE_PATH_CAPACITY) return {};
+    strncpy(key.source_path, source_path, ASSET_CACHE_PATH_CAPACITY - 1);
+
+    struct stat source_stat = {};
+    if (stat(source_path, &source_stat) < 0) return {};
+    key.source_mtime = (int64_t) source_stat.st_mtime;
+
+    auto source = map_file(source_path);
+    if (!source.has_value) return {};
+    defer(unmap_file(source.unwrap));
+
+    key.source_size = source.unwrap.size;
+    key.source_hash = asset_cache_hash(source.unwrap.data, source.unwrap.size);
+
+    return {true, key};
+}
+
+static size_t asset_cache_align(size_t offset)
+{
+    return (offset + ASSET_CACHE_PAYLOAD_ALIGNMENT - 1) / ASSET_CACHE_PAYLOAD_ALIGNMENT * ASSET_CACHE_PAYLOAD_ALIGNMENT;
+}
+
+bool save_asset_cache(const char *filepath, const Asset_Cache_Blob *blobs, size_t blobs_count)
+{
+    Asset_Cache_Header header = {};
+    memcpy(header.magic, ASSET_CACHE_MAGIC, sizeof(header.magic));
+    header.version = ASSET_CACHE_VERSION;
+    header.entries_count = (uint32_t) blobs_count;
+
+    Dynamic_Array<Asset_Cache_Entry> entries = {};
+    defer(entries.release());
+    entries.reserve(blobs_count);
+
+    size_t offset = sizeof(header) + blobs_count * sizeof(Asset_Cache_Entry);
+    for (size_t i = 0; i < blobs_count; ++i) {
+        offset = asset_cache_align(offset);
+
+        Asset_Cache_Entry entry = {};
+        entry.key = blobs[i].key;
+        entry.kind = blobs[i].kind;
+        entry.width = blobs[i].width;
+        entry.height = blobs[i].height;
+        entry.offset = offset;
+        entry.size = blobs[i].size;
+        entries.push(entry);
+
+        offset += blobs[i].size;
+    }
+
+    FILE *f = fopen(filepath, "wb");
+    if (f == NULL) return false;
+    defer(fclose(f));
+
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(entries.data, sizeof(entries.data[0]), entries.size, f);
+
+    const char padding[ASSET_CACHE_PAYLOAD_ALIGNMENT] = {};
+    size_t written = sizeof(header) + entries.size * sizeof(entries.data[0]);
+    for (size_t i = 0; i < blobs_count; ++i) {
+        fwrite(padding, 1, entries.data[i].offset - written, f);
+        fwrite(blobs[i].data, 1, blobs[i].size, f);
+        written = entries.data[i].offset + blobs[i].size;
+    }
+
+    return !ferror(f);
+}
@@ -0,0 +1,104 @@
+#ifndef SOMETHING_ASSET_CACHE_HPP_
+#define SOMETHING_ASSET_CACHE_HPP_
+
+// NOTE: Asset cache is a single file with the decoded assets of the
+// previous run, so the warm starts don't have to decode them again:
+//
+//   Asset_Cache_Header
+//   Asset_Cache_Entry[header.entries_count]
+//   payloads of the entries
+//
+// Every entry is keyed by the path, size, modification time and FNV-1a
+// hash of the contents of its source file. The payload of a
+// Pixels entry is width * height RGBA32 pixels and the payload of a
+// Pcm_S16 entry is the samples of a Sample_S16. All of the integers
+// are stored in the native byte order.
+//
+// The file is rebuilt from scratch whenever there was a miss.
+
+const char *const ASSET_CACHE_FILE_PATH = "./assets.cache";
+const char ASSET_CACHE_MAGIC[4] = {'S', 'A', 'C', 'H'};
+const uint32_t ASSET_CACHE_VERSION = 1;
+const size_t ASSET_CACHE_PATH_CAPACITY = 128;
+const size_t ASSET_CACHE_PAYLOAD_ALIGNMENT = 16;
+
+enum class Asset_Cache_Kind : uint32_t
+{
+    Pixels = 0,
+    Pcm_S16,
+};
+
+struct Asset_Cache_Key
+{
+    char source_path[ASSET_CACHE_PATH_CAPACITY];
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t source_hash;
+
+    bool operator==(const Asset_Cache_Key &that) const;
+};
+
+struct Asset_Cache_Header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t entries_count;
+    uint32_t reserved;
+};
+
+struct Asset_Cache_Entry
+{
+    Asset_Cache_Key key;
+    Asset_Cache_Kind kind;
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved;
+    // NOTE: offset of the payload from the beginning of the file
+    uint64_t offset;
+    uint64_t size;
+};
+
+// NOTE: an entry to be saved. `data` is not owned by the blob.
+struct Asset_Cache_Blob
+{
+    Asset_Cache_Key key;
+    Asset_Cache_Kind kind;
+    uint32_t width;
+    uint32_t height;
+    const void *data;
+    size_t size;
+};
+
+struct Asset_Cache_Stats
+{
+    SDL_atomic_t hits;
+    SDL_atomic_t misses;
+};
+
+// NOTE: open() only reads the cache, so find() and payload() can be
+// called from any thread until close()
+struct Asset_Cache
+{
+    bool is_open;
+    Mapped_File file;
+    Asset_Cache_Header header;
+    const Asset_Cache_Entry *entries;
+
+    Asset_Cache_Stats stats;
+
+    bool open(const char *filepath);
+    void close();
+    const Asset_Cache_Entry *find(const Asset_Cache_Key *key, Asset_Cache_Kind kind) const;
+    const void *payload(const Asset_Cache_Entry *entry) const;
+};
+
+Asset_Cache asset_cache = {};
+
+// NOTE: Reads the whole source file to hash it. Fails when the file
+// can't be read or the path is too long to be a key.
+Maybe<Asset_Cache_Key> asset_cache_key(const char *source_path);
+
+// NOTE: on failure errno describes the reason
+bool save_asset_cache(const char *filepath, const Asset_Cache_Blob *blobs, size_t blobs_count);
+
+#endif  // SOMETHING_ASSET_CACHE_HPP_
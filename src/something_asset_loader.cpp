@@ -0,0 +1,243 @@
+#include "./something_asset_loader.hpp"
+
+const char *Asset_Job::file_path() const
+{
+    switch (kind) {
+    case Asset_Kind::Texture: return texture_files[index];
+    case Asset_Kind::Sample:  return sample_s16_files[index].file_path;
+    case Asset_Kind::Animat:  return frame_animat_files[index].file_path;
+    }
+
+    return "";
+}
+
+static bool asset_loader_load_cached(Asset_Job *job)
+{
+    job->cache_key = asset_cache_key(job->file_path());
+    if (!job->cache_key.has_value) return false;
+
+    switch (job->kind) {
+    case Asset_Kind::Texture: {
+        const auto entry = asset_cache.find(&job->cache_key.unwrap, Asset_Cache_Kind::Pixels);
+        if (entry == nullptr) return false;
+
+        // NOTE: copied out of the cache, because the texture owns its
+        // pixels and the cache is unmapped after the loading
+        uint32_t *pixels = (uint32_t *) malloc(entry->size);
+        if (pixels == NULL) return false;
+        memcpy(pixels, asset_cache.payload(entry), entry->size);
+
+        set_texture_surface(job->index, surface_from_rgba32_pixels(pixels, (int) entry->width, (int) entry->height));
+    } break;
+
+    case Asset_Kind::Sample: {
+        const auto entry = asset_cache.find(&job->cache_key.unwrap, Asset_Cache_Kind::Pcm_S16);
+        if (entry == nullptr) return false;
+
+        int16_t *audio_buf = (int16_t *) malloc(entry->size);
+        if (audio_buf == NULL) return false;
+        memcpy(audio_buf, asset_cache.payload(entry), entry->size);
+
+        Sample_S16 sample = {};
+        sample.audio_buf = audio_buf;
+        sample.audio_len = (Uint32) (entry->size / sizeof(int16_t));
+        sample_s16_files[job->index].sample = sample;
+    } break;
+
+    case Asset_Kind::Animat:
+        return false;
+    }
+
+    return true;
+}
+
+int asset_loader_worker(void *data)
+{
+    Asset_Loader *loader = (Asset_Loader *) data;
+
+    while (true) {
+        const size_t i = (size_t) SDL_AtomicAdd(&loader->next_job, 1);
+        if (i >= loader->jobs_count) break;
+
+        Asset_Job *job = &loader->jobs[i];
+        job->decode_begin = SDL_GetPerformanceCounter();
+
+        // NOTE: the animats are cheaper to parse than to look up
+        if (job->kind != Asset_Kind::Animat) {
+            job->cache_hit = asset_loader_load_cached(job);
+            SDL_AtomicAdd(job->cache_hit ? &asset_cache.stats.hits : &asset_cache.stats.misses, 1);
+        }
+
+        if (!job->cache_hit) {
+            switch (job->kind) {
+            case Asset_Kind::Texture: {
+                decode_texture(job->index);
+            } break;
+
+            case Asset_Kind::Sample: {
+                sample_s16_files[job->index].sample = load_wav_as_sample_s16(sample_s16_files[job->index].file_path);
+            } break;
+
+            case Asset_Kind::Animat: {
+                frame_animat_files[job->index].animat = load_animat_file(frame_animat_files[job->index].file_path);
+            } break;
+            }
+        }
+        job->decode_end = SDL_GetPerformanceCounter();
+
+        SDL_AtomicSet(&job->decoded, 1);
+        sec(SDL_SemPost(loader->decoded_sem));
+    }
+
+    return 0;
+}
+
+void Asset_Loader::load(SDL_Renderer *renderer)
+{
+    begin = SDL_GetPerformanceCounter();
+
+    jobs_count = 0;
+    const auto push_job = [&](Asset_Kind kind, size_t index) {
+        assert(jobs_count < ASSET_JOBS_CAPACITY);
+        Asset_Job job = {};
+        job.kind = kind;
+        job.index = index;
+        jobs[jobs_count++] = job;
+    };
+
+    for (size_t i = 0; i < TEXTURE_COUNT; ++i) {
+        if (textures[i] == nullptr) {
+            push_job(Asset_Kind::Texture, i);
+        }
+    }
+    for (size_t i = 0; i < sample_s16_files_count; ++i) {
+        push_job(Asset_Kind::Sample, i);
+    }
+    for (size_t i = 0; i < frame_animat_files_count; ++i) {
+        push_job(Asset_Kind::Animat, i);
+    }
+
+    asset_cache.open(ASSET_CACHE_FILE_PATH);
+
+    SDL_AtomicSet(&next_job, 0);
+    decoded_sem = sec(SDL_CreateSemaphore(0));
+
+    // NOTE: the main thread is busy with the uploads, so it's not
+    // counted
+    threads_count = (size_t) clamp(SDL_GetCPUCount() - 1, 1, (int) ASSET_LOADER_THREADS_CAPACITY);
+    for (size_t i = 0; i < threads_count; ++i) {
+        threads[i] = sec(SDL_CreateThread(asset_loader_worker, "asset loader", this));
+    }
+
+    for (size_t decoded = 0; decoded < jobs_count; ++decoded) {
+        sec(SDL_SemWait(decoded_sem));
+
+        for (size_t i = 0; i < jobs_count; ++i) {
+            Asset_Job *job = &jobs[i];
+            if (job->kind != Asset_Kind::Texture || job->uploaded) continue;
+            if (!SDL_AtomicGet(&job->decoded)) continue;
+
+            job->upload_begin = SDL_GetPerformanceCounter();
+            upload_texture(renderer, job->index);
+            job->upload_end = SDL_GetPerformanceCounter();
+            job->uploaded = true;
+        }
+    }
+
+    for (size_t i = 0; i < threads_count; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    SDL_DestroySemaphore(decoded_sem);
+    decoded_sem = nullptr;
+
+    asset_cache.close();
+    cache_saved = false;
+    if (SDL_AtomicGet(&asset_cache.stats.misses) > 0) {
+        cache_saved = save_cache();
+    }
+
+    end = SDL_GetPerformanceCounter();
+}
+
+bool Asset_Loader::save_cache()
+{
+    Asset_Cache_Blob blobs[ASSET_JOBS_CAPACITY] = {};
+    size_t blobs_count = 0;
+
+    for (size_t i = 0; i < jobs_count; ++i) {
+        const Asset_Job *job = &jobs[i];
+        if (!job->cache_key.has_value) continue;
+
+        Asset_Cache_Blob blob = {};
+        blob.key = job->cache_key.unwrap;
+
+        switch (job->kind) {
+        case Asset_Kind::Texture: {
+            const SDL_Surface *surface = surfaces[job->index];
+            blob.kind = Asset_Cache_Kind::Pixels;
+            blob.width = (uint32_t) surface->w;
+            blob.height = (uint32_t) surface->h;
+            blob.data = surface->pixels;
+            blob.size = (size_t) surface->w * (size_t) surface->h * sizeof(uint32_t);
+        } break;
+
+        case Asset_Kind::Sample: {
+            const Sample_S16 sample = sample_s16_files[job->index].sample;
+            blob.kind = Asset_Cache_Kind::Pcm_S16;
+            blob.data = sample.audio_buf;
+            blob.size = sample.audio_len * sizeof(int16_t);
+        } break;
+
+        case Asset_Kind::Animat:
+            continue;
+        }
+
+        blobs[blobs_count++] = blob;
+    }
+
+    if (!save_asset_cache(ASSET_CACHE_FILE_PATH, blobs, blobs_count)) {
+        println(stderr, "[WARN] Could not save the asset cache `", ASSET_CACHE_FILE_PATH, "`: ", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+void Asset_Loader::print_timeline(FILE *stream, Uint64 startup_begin)
+{
+    const float ms_per_count = 1000.0f / (float) SDL_GetPerformanceFrequency();
+    auto at = [&](Uint64 counter) {
+        return (float) (counter - startup_begin) * ms_per_count;
+    };
+
+    fprintf(stream, "[STARTUP] %9s %9s %9s %9s  %s\n",
+            "decode at", "decode", "upload at", "upload", "asset");
+    for (size_t i = 0; i < jobs_count; ++i) {
+        const Asset_Job *job = &jobs[i];
+        const char *cached = job->cache_hit ? " (cached)" : "";
+        if (job->uploaded) {
+            fprintf(stream, "[STARTUP] %7.2fms %7.2fms %7.2fms %7.2fms  %s%s\n",
+                    at(job->decode_begin), (float) (job->decode_end - job->decode_begin) * ms_per_count,
+                    at(job->upload_begin), (float) (job->upload_end - job->upload_begin) * ms_per_count,
+                    job->file_path(), cached);
+        } else {
+            fprintf(stream, "[STARTUP] %7.2fms %7.2fms %9s %9s  %s%s\n",
+                    at(job->decode_begin), (float) (job->decode_end - job->decode_begin) * ms_per_count,
+                    "-", "-",
+                    job->file_path(), cached);
+        }
+    }
+    fprintf(stream, "[STARTUP] asset cache `%s`: %d hits, %d misses%s\n",
+            ASSET_CACHE_FILE_PATH,
+            SDL_AtomicGet(&asset_cache.stats.hits),
+            SDL_AtomicGet(&asset_cache.stats.misses),
+            cache_saved ? ", saved" : "");
+    fprintf(stream, "[STARTUP] %zu assets loaded in %.2fms by %zu threads, done at %.2fms\n",
+            jobs_count, (float) (end - begin) * ms_per_count, threads_count, at(end));
+}
+
+void load_assets(SDL_Renderer *renderer, Uint64 startup_begin)
+{
+    asset_loader.load(renderer);
+    asset_loader.print_timeline(stderr, startup_begin);
+}
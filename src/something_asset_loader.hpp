@@ -0,0 +1,71 @@
+#ifndef SOMETHING_ASSET_LOADER_HPP_
+#define SOMETHING_ASSET_LOADER_HPP_
+
+const size_t ASSET_LOADER_THREADS_CAPACITY = 8;
+const size_t ASSET_JOBS_CAPACITY = TEXTURE_COUNT + sample_s16_files_count + frame_animat_files_count;
+
+enum class Asset_Kind
+{
+    Texture = 0,
+    Sample,
+    Animat,
+};
+
+// NOTE: all of the counters are SDL_GetPerformanceCounter()
+// values. upload_begin and upload_end stay 0 for the assets that
+// don't have to be uploaded to the renderer.
+struct Asset_Job
+{
+    Asset_Kind kind;
+    size_t index;
+    Uint64 decode_begin;
+    Uint64 decode_end;
+    Uint64 upload_begin;
+    Uint64 upload_end;
+    // NOTE: set by the worker after the decoded asset is in place
+    SDL_atomic_t decoded;
+    bool uploaded;
+
+    Maybe<Asset_Cache_Key> cache_key;
+    bool cache_hit;
+
+    const char *file_path() const;
+};
+
+// NOTE: Decodes all of the textures, samples and animats on a pool of
+// worker threads. The workers pick the next job by bumping `next_job`,
+// and post `decoded_sem` for every finished job. The main thread
+// uploads the decoded textures to the renderer as soon as they are
+// ready, while the rest of the assets are still being decoded.
+//
+// The textures and the samples are taken from asset_cache when it has
+// them. When any of them were not there the cache is saved again at
+// the end.
+struct Asset_Loader
+{
+    Asset_Job jobs[ASSET_JOBS_CAPACITY];
+    size_t jobs_count;
+    SDL_atomic_t next_job;
+    SDL_sem *decoded_sem;
+
+    SDL_Thread *threads[ASSET_LOADER_THREADS_CAPACITY];
+    size_t threads_count;
+
+    Uint64 begin;
+    Uint64 end;
+    bool cache_saved;
+
+    void load(SDL_Renderer *renderer);
+    bool save_cache();
+    void print_timeline(FILE *stream, Uint64 startup_begin);
+};
+
+Asset_Loader asset_loader = {};
+
+int asset_loader_worker(void *data);
+
+// NOTE: the parallel equivalent of load_textures(), load_samples()
+// and load_frame_animat_files()
+void load_assets(SDL_Renderer *renderer, Uint64 startup_begin);
+
+#endif  // SOMETHING_ASSET_LOADER_HPP_
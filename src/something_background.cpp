@@ -1,38 +1,88 @@
 #include "./something_background.hpp"
 
-void Background::render(SDL_Renderer *renderer, Camera camera)
+void Background::update_layer_cache(SDL_Renderer *renderer, size_t layer_index)
 {
-    for (size_t i = 0; i < BACKGROUND_LAYERS_COUNT; ++i) {
-        const float w = (float) layers[i].srcrect.w * BACKGROUND_SCALE_FACTOR;
-        const float h = (float) layers[i].srcrect.h * BACKGROUND_SCALE_FACTOR;
-        const auto s = vec2(w, h);
+    const auto layer = layers[layer_index];
+    auto cache = &caches[layer_index];
 
-        auto p = (camera.pos / s).map(floorf) * s + -camera.pos * BACKGROUND_PARALLAX_FACTOR * (float) i;
+    if (cache->texture != nullptr) {
+        SDL_DestroyTexture(cache->texture);
+    }
 
-        while (p.x + w < 0.0f) {
-            p.x += w;
-        }
+    cache->scale = BACKGROUND_SCALE_FACTOR;
+    cache->tile_width = max((int) roundf((float) layer.srcrect.w * BACKGROUND_SCALE_FACTOR), 1);
+    cache->tile_height = max((int) roundf((float) layer.srcrect.h * BACKGROUND_SCALE_FACTOR), 1);
+
+    // NOTE: the cache covers the screen with whole repeats of the layer,
+    // so it's still seamless when it's wrapped around
+    const int cols = max((int) ceilf(SCREEN_WIDTH / (float) cache->tile_width), 1);
+    const int rows = max((int) ceilf(SCREEN_HEIGHT / (float) cache->tile_height), 1);
+    cache->width = cols * cache->tile_width;
+    cache->height = rows * cache->tile_height;
 
-        while (p.x > 0.0f) {
-            p.x -= w;
+    cache->texture = sec(SDL_CreateTexture(renderer,
+                                           SDL_PIXELFORMAT_RGBA32,
+                                           SDL_TEXTUREACCESS_TARGET,
+                                           cache->width,
+                                           cache->height));
+    sec(SDL_SetTextureBlendMode(cache->texture, SDL_BLENDMODE_BLEND));
+
+    // NOTE: the repeats of the layer don't overlap, so the layer can be
+    // baked as is
+    const auto bake = begin_bake(renderer, cache->texture);
+
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            layer.render(renderer, rect(vec2((float) (col * cache->tile_width),
+                                             (float) (row * cache->tile_height)),
+                                        (float) cache->tile_width,
+                                        (float) cache->tile_height));
         }
+    }
+
+    end_bake(renderer, bake);
+}
 
-        while (p.y + h < 0.0f) {
-            p.y += h;
+void Background::invalidate_caches()
+{
+    for (size_t i = 0; i < BACKGROUND_LAYERS_COUNT; ++i) {
+        if (caches[i].texture != nullptr) {
+            SDL_DestroyTexture(caches[i].texture);
         }
+        caches[i] = {};
+    }
+}
+
+void Background::render(SDL_Renderer *renderer, Camera camera)
+{
+    for (size_t i = 0; i < BACKGROUND_LAYERS_COUNT; ++i) {
+        if (layers[i].srcrect.w <= 0 || layers[i].srcrect.h <= 0) continue;
 
-        while (p.y > 0.0f) {
-            p.y -= h;
+        if (caches[i].texture == nullptr || caches[i].scale != BACKGROUND_SCALE_FACTOR) {
+            update_layer_cache(renderer, i);
         }
 
-        float the_original_hwy = p.y;
-        while (p.x < (float) SCREEN_WIDTH) {
-            p.y = the_original_hwy;
-            while (p.y < (float) SCREEN_HEIGHT) {
-                layers[i].render(renderer, rect(p, w, h));
-                p.y += h;
+        const auto cache = caches[i];
+
+        // NOTE: the layer repeats every tile_width/tile_height pixels,
+        // so only the offset within a single repeat matters
+        auto p = -camera.pos * BACKGROUND_PARALLAX_FACTOR * (float) i;
+        p.x = fmodf(p.x, (float) cache.tile_width);
+        p.y = fmodf(p.y, (float) cache.tile_height);
+        if (p.x > 0.0f) p.x -= (float) cache.tile_width;
+        if (p.y > 0.0f) p.y -= (float) cache.tile_height;
+
+        // NOTE: the cache is at least as big as the screen, so this is at
+        // most 2x2 blits
+        for (float y = p.y; y < SCREEN_HEIGHT; y += (float) cache.height) {
+            for (float x = p.x; x < SCREEN_WIDTH; x += (float) cache.width) {
+                const SDL_Rect srcrect = {0, 0, cache.width, cache.height};
+                const SDL_Rect dstrect = rectf_for_sdl(rect(vec2(x, y),
+                                                            (float) cache.width,
+                                                            (float) cache.height));
+                render_copy(renderer, cache.texture, &srcrect, &dstrect,
+                            SDL_FLIP_NONE, RGBA8 {255, 255, 255, 255});
             }
-            p.x += w;
         }
     }
 }
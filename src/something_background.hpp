@@ -3,11 +3,32 @@
 
 const size_t BACKGROUND_LAYERS_COUNT = 4;
 
+// NOTE: a layer pre-scaled by BACKGROUND_SCALE_FACTOR and repeated
+// enough times to cover the whole screen, so it can be drawn with at
+// most four blits no matter the scale and the screen size.
+struct Background_Layer_Cache
+{
+    SDL_Texture *texture;
+    // NOTE: size of the whole cache texture
+    int width;
+    int height;
+    // NOTE: size of a single scaled repeat of the layer
+    int tile_width;
+    int tile_height;
+    // NOTE: BACKGROUND_SCALE_FACTOR the cache was built with
+    float scale;
+};
+
 struct Background
 {
     Sprite layers[BACKGROUND_LAYERS_COUNT];
+    Background_Layer_Cache caches[BACKGROUND_LAYERS_COUNT];
 
     void render(SDL_Renderer *renderer, Camera camera);
+    void update_layer_cache(SDL_Renderer *renderer, size_t layer_index);
+    // NOTE: must be called when the content of the render targets is lost
+    // (SDL_RENDER_TARGETS_RESET, SDL_RENDER_DEVICE_RESET)
+    void invalidate_caches();
 };
 
 #endif  // SOMETHING_BACKGROUND_HPP_
@@ -0,0 +1,365 @@
+// NOTE: Headless benchmark harness. It is compiled as a separate unity
+// build (see the `bench` target of the Makefile) that includes the whole
+// game without its main() and measures the hot paths in isolation.
+//
+// Usage: ./something.bench [--csv]
+#define SOMETHING_BENCH
+#include "something.cpp"
+
+const float BENCH_MIN_SEC = 0.25f;
+const int BENCH_ROOMS_ROWS = 10;
+const int BENCH_ROOMS_COLS = 10;
+const int BENCH_ROOMS_PADDING = 1;
+const size_t BENCH_ROOMS_COUNT = BENCH_ROOMS_ROWS * BENCH_ROOMS_COLS;
+const size_t BENCH_SIGHTS_COUNT = 10 * 1000;
+const size_t BENCH_HITBOXES_CAPACITY = 10 * 1000;
+const float BENCH_PROJECTILE_SPEED = 1200.0f;
+const float BENCH_DELTA_TIME = 1.0f / 60.0f;
+
+struct Bench_Result
+{
+    const char *name;
+    size_t n;
+    size_t iterations;
+    double total_sec;
+};
+
+Dynamic_Array<Bench_Result> bench_results = {};
+
+// NOTE: results of the benchmarked code are accumulated here so the
+// optimizer can't throw the code away
+volatile size_t bench_sink = 0;
+
+// NOTE: `n` is the amount of items processed by a single call of
+// `body`. It's only used to report the time per item.
+template <typename Body>
+void bench(const char *name, size_t n, Body body)
+{
+    const double frequency = (double) SDL_GetPerformanceFrequency();
+    const Uint64 begin = SDL_GetPerformanceCounter();
+    Uint64 end = begin;
+    size_t iterations = 0;
+
+    do {
+        body();
+        iterations += 1;
+        end = SDL_GetPerformanceCounter();
+    } while ((double) (end - begin) / frequency < BENCH_MIN_SEC);
+
+    bench_results.push({name, n, iterations, (double) (end - begin) / frequency});
+}
+
+void print_results_json(FILE *stream)
+{
+    fprintf(stream, "{\"benchmarks\":[\n");
+    for (size_t i = 0; i < bench_results.size; ++i) {
+        const auto &result = bench_results.data[i];
+        const double ns_per_iteration = result.total_sec * 1e9 / (double) result.iterations;
+        fprintf(stream,
+                "%s{\"name\":\"%s\",\"n\":%zu,\"iterations\":%zu,\"ns_per_iteration\":%.1f,\"ns_per_item\":%.3f}",
+                i == 0 ? "" : ",\n",
+                result.name, result.n, result.iterations,
+                ns_per_iteration, ns_per_iteration / (double) max(result.n, (size_t) 1));
+    }
+    fprintf(stream, "\n]}\n");
+}
+
+void print_results_csv(FILE *stream)
+{
+    fprintf(stream, "name,n,iterations,ns_per_iteration,ns_per_item\n");
+    for (size_t i = 0; i < bench_results.size; ++i) {
+        const auto &result = bench_results.data[i];
+        const double ns_per_iteration = result.total_sec * 1e9 / (double) result.iterations;
+        fprintf(stream, "%s,%zu,%zu,%.1f,%.3f\n",
+                result.name, result.n, result.iterations,
+                ns_per_iteration, ns_per_iteration / (double) max(result.n, (size_t) 1));
+    }
+}
+
+// NOTE: static because the grid is 32MB
+Tile_Grid bench_grid = {};
+Particles bench_particles = {};
+Recti bench_rooms[BENCH_ROOMS_COUNT] = {};
+Rectf bench_hitboxes[BENCH_HITBOXES_CAPACITY] = {};
+
+Vec2f random_point_in_room(Recti room)
+{
+    return vec2(rand_float_range((float) room.x, (float) (room.x + room.w)),
+                rand_float_range((float) room.y, (float) (room.y + room.h))) * TILE_SIZE;
+}
+
+int main(int argc, char *argv[])
+{
+    bool csv = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            println(stderr, "Usage: ", argv[0], " [--csv]");
+            return 1;
+        }
+    }
+
+    // NOTE: fixed seed so every run benchmarks the same level
+    srand(69);
+
+    SDL_Surface *screen = sec(SDL_CreateRGBSurfaceWithFormat(
+                                  0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+                                  SDL_PIXELFORMAT_RGBA32));
+    defer(SDL_FreeSurface(screen));
+    SDL_Renderer *renderer = sec(SDL_CreateSoftwareRenderer(screen));
+    defer(SDL_DestroyRenderer(renderer));
+    sec(SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND));
+
+    init_hue_lut();
+    load_textures(renderer);
+    load_samples();
+    load_frame_animat_files();
+    init_tile_defs(texture_index_by_name("./assets/sprites/fantasy_tiles.png"_sv));
+
+    auto room_files = load_room_files_from_dir("./assets/rooms/");
+    if (room_files.size == 0) {
+        println(stderr, "No rooms found in ./assets/rooms/");
+        abort();
+    }
+
+    size_t room_indices[BENCH_ROOMS_COUNT] = {};
+    for (int y = 0; y < BENCH_ROOMS_ROWS; ++y) {
+        for (int x = 0; x < BENCH_ROOMS_COLS; ++x) {
+            const size_t i = (size_t) (y * BENCH_ROOMS_COLS + x);
+            const auto coord = vec2(x * (ROOM_WIDTH + BENCH_ROOMS_PADDING),
+                                    y * (ROOM_HEIGHT + BENCH_ROOMS_PADDING));
+            room_indices[i] = (size_t) rand() % room_files.size;
+            bench_rooms[i] = rect(coord, ROOM_WIDTH, ROOM_HEIGHT);
+        }
+    }
+
+    //// GRID ////////////////////////////////////////
+
+    bench("grid_fill", BENCH_ROOMS_COUNT, [&]() {
+        for (size_t i = 0; i < BENCH_ROOMS_COUNT; ++i) {
+            bench_grid.load_room_from_file(
+                room_files.data[room_indices[i]].data,
+                rect_top_left(bench_rooms[i]));
+        }
+    });
+
+    {
+        auto rooms = map_room_files(room_files);
+        defer(unmap_room_files(&rooms));
+
+        bench("grid_fill_mapped", BENCH_ROOMS_COUNT, [&]() {
+            for (size_t i = 0; i < BENCH_ROOMS_COUNT; ++i) {
+                const auto room = rooms.data[room_indices[i]];
+                bench_grid.load_room_from_memory(room.data, room.size, rect_top_left(bench_rooms[i]));
+            }
+        });
+    }
+
+    bench("grid_render", BENCH_ROOMS_COUNT, [&]() {
+        for (size_t i = 0; i < BENCH_ROOMS_COUNT; ++i) {
+            Camera camera = {};
+            camera.pos = vec_cast<float>(rect_center(bench_rooms[i])) * TILE_SIZE;
+            bench_grid.render(renderer, camera, &bench_rooms[i]);
+        }
+    });
+
+    bench("grid_render_buffered", BENCH_ROOMS_COUNT, [&]() {
+        for (size_t i = 0; i < BENCH_ROOMS_COUNT; ++i) {
+            Camera camera = {};
+            camera.pos = vec_cast<float>(rect_center(bench_rooms[i])) * TILE_SIZE;
+            render_buffer.begin(renderer);
+            render_buffer.layer = Render_Layer::Grid;
+            bench_grid.render(renderer, camera, &bench_rooms[i]);
+            render_buffer.flush(renderer);
+        }
+    });
+
+    bench("bfs_to_tile", BENCH_ROOMS_COUNT, [&]() {
+        for (size_t i = 0; i < BENCH_ROOMS_COUNT; ++i) {
+            bench_grid.bfs_to_tile(rect_center(bench_rooms[i]), &bench_rooms[i]);
+            bench_sink += (size_t) bench_grid.bfs_trace[0][0];
+        }
+    });
+
+    {
+        static Vec2f sights[BENCH_SIGHTS_COUNT][2] = {};
+        for (size_t i = 0; i < BENCH_SIGHTS_COUNT; ++i) {
+            const auto room = bench_rooms[(size_t) rand() % BENCH_ROOMS_COUNT];
+            sights[i][0] = random_point_in_room(room);
+            sights[i][1] = random_point_in_room(room);
+        }
+
+        bench("a_sees_b", BENCH_SIGHTS_COUNT, [&]() {
+            for (size_t i = 0; i < BENCH_SIGHTS_COUNT; ++i) {
+                bench_sink += bench_grid.a_sees_b(sights[i][0], sights[i][1]);
+            }
+        });
+    }
+
+    //// BACKGROUND ////////////////////////////////////////
+
+    {
+        Background background = {};
+        background.layers[0] = sprite_from_texture_index(texture_index_by_name("./assets/sprites/parallax-forest-lights.png"_sv));
+        background.layers[1] = sprite_from_texture_index(texture_index_by_name("./assets/sprites/parallax-forest-middle-trees.png"_sv));
+        background.layers[2] = sprite_from_texture_index(texture_index_by_name("./assets/sprites/parallax-forest-front-trees.png"_sv));
+        defer(background.invalidate_caches());
+
+        bench("background_render", BENCH_ROOMS_COUNT, [&]() {
+            for (size_t i = 0; i < BENCH_ROOMS_COUNT; ++i) {
+                Camera camera = {};
+                camera.pos = vec_cast<float>(rect_center(bench_rooms[i])) * TILE_SIZE;
+                background.render(renderer, camera);
+            }
+        });
+    }
+
+    //// FONT ////////////////////////////////////////
+
+    {
+        Bitmap_Font font = {};
+        font.bitmap = load_texture_from_bmp_file(renderer, "./assets/fonts/charmap-oldschool.bmp", {0, 0, 0, 255});
+        const auto font_size = vec2(FONT_DEBUG_SIZE, FONT_DEBUG_SIZE);
+        const String_View lines[] = {
+            "FPS: 60"_sv,
+            "Mouse Position: 1234.5 678.9"_sv,
+            "Collision Probe: 1234.5 678.9"_sv,
+            "Projectiles: 69"_sv,
+            "Player position: 1234.5 678.9"_sv,
+        };
+        const size_t lines_count = sizeof(lines) / sizeof(lines[0]);
+
+        bench("font_render_shadowed", lines_count, [&]() {
+            for (size_t i = 0; i < lines_count; ++i) {
+                font.render_shadowed(renderer, vec2(0.0f, 50.0f * (float) i), vec2(-2.0f, -2.0f),
+                                     font_size, rgba8(FONT_DEBUG_COLOR), rgba8(FONT_SHADOW_COLOR),
+                                     lines[i]);
+            }
+        });
+
+        static Text_Texture text_textures[lines_count] = {};
+        bench("font_render_cached", lines_count, [&]() {
+            for (size_t i = 0; i < lines_count; ++i) {
+                font.render_cached(renderer, &text_textures[i], vec2(0.0f, 50.0f * (float) i),
+                                   font_size, rgba8(FONT_DEBUG_COLOR), lines[i]);
+            }
+        });
+    }
+
+    //// PARTICLES ////////////////////////////////////////
+
+    {
+        // NOTE: the emitter is disabled and the lifetimes are huge so
+        // the system stays at full capacity during the whole benchmark
+        bench_particles.state = Particles::DISABLED;
+        bench_particles.current_color = {0.0f, 0.8f, 0.5f, 1.0f};
+        for (size_t i = 0; i < PARTICLES_CAPACITY; ++i) {
+            bench_particles.source = random_point_in_room(bench_rooms[i % BENCH_ROOMS_COUNT]);
+            bench_particles.push(rand_float_range(100.0f, 1000.0f));
+            bench_particles.lifetimes[i] = 1e9f;
+        }
+        assert(bench_particles.count == PARTICLES_CAPACITY);
+
+        bench("particles_update", PARTICLES_CAPACITY, [&]() {
+            bench_particles.update(BENCH_DELTA_TIME, &bench_grid);
+        });
+    }
+
+    {
+        static HSLA hsla[PARTICLES_CAPACITY] = {};
+        static RGBA rgba[PARTICLES_CAPACITY] = {};
+        for (size_t i = 0; i < PARTICLES_CAPACITY; ++i) {
+            hsla[i] = {rand_float_range(-30.0f, 390.0f), rand_float_range(0.0f, 1.0f),
+                       rand_float_range(0.0f, 1.0f), 1.0f};
+        }
+
+        bench("hsla_to_rgba", PARTICLES_CAPACITY, [&]() {
+            hsla_to_rgba(hsla, rgba, PARTICLES_CAPACITY);
+            bench_sink += (size_t) rgba[0].r;
+        });
+
+        bench("hsla_to_rgba_lut", PARTICLES_CAPACITY, [&]() {
+            hsla_to_rgba_lut(hsla, rgba, PARTICLES_CAPACITY);
+            bench_sink += (size_t) rgba[0].r;
+        });
+
+        bench("rgba_to_hsla", PARTICLES_CAPACITY, [&]() {
+            rgba_to_hsla(rgba, hsla, PARTICLES_CAPACITY);
+            bench_sink += (size_t) hsla[0].h;
+        });
+    }
+
+    //// PROJECTILES ////////////////////////////////////////
+
+    {
+        // NOTE: Mirrors the projectile vs entity part of
+        // Game::update_projectiles. Game can only hold ENTITIES_COUNT
+        // entities, so the hitboxes are synthetic here to measure how
+        // the loop scales with the amount of entities.
+        static Vec2f segments[PROJECTILES_COUNT][2] = {};
+        for (size_t i = 0; i < PROJECTILES_COUNT; ++i) {
+            segments[i][0] = random_point_in_room(bench_rooms[i % BENCH_ROOMS_COUNT]);
+            segments[i][1] = segments[i][0] +
+                polar(BENCH_PROJECTILE_SPEED * BENCH_DELTA_TIME, rand_float_range(0.0f, 2.0f * PI));
+        }
+
+        for (size_t i = 0; i < BENCH_HITBOXES_CAPACITY; ++i) {
+            const auto center = random_point_in_room(bench_rooms[i % BENCH_ROOMS_COUNT]);
+            bench_hitboxes[i] = rect(center - vec2(TILE_SIZE, TILE_SIZE) * 0.5f, TILE_SIZE, TILE_SIZE);
+        }
+
+        const struct {
+            const char *name;
+            size_t n;
+        } projectile_scenarios[] = {
+            {"projectiles_vs_entities_69", ENTITIES_COUNT},
+            {"projectiles_vs_entities_1k", 1000},
+            {"projectiles_vs_entities_10k", BENCH_HITBOXES_CAPACITY},
+        };
+
+        for (const auto &scenario : projectile_scenarios) {
+            const size_t n = scenario.n;
+            bench(scenario.name, PROJECTILES_COUNT * n, [&]() {
+                for (size_t i = 0; i < PROJECTILES_COUNT; ++i) {
+                    float hit_t = 1.0f;
+                    size_t hit_index = n;
+                    for (size_t j = 0; j < n; ++j) {
+                        auto t = segment_rect_intersection(segments[i][0], segments[i][1], bench_hitboxes[j]);
+                        if (t.has_value && t.unwrap <= hit_t) {
+                            hit_t = t.unwrap;
+                            hit_index = j;
+                        }
+                    }
+                    bench_sink += hit_index;
+                }
+            });
+        }
+    }
+
+    //// SOUND ////////////////////////////////////////
+
+    {
+        Sample_Mixer mixer = {};
+        mixer.volume = 0.2f;
+        static int16_t stream[SOMETHING_SOUND_SAMPLES * SOMETHING_SOUND_CHANNELS] = {};
+
+        bench("sample_mixer_audio_callback", SOMETHING_SOUND_SAMPLES, [&]() {
+            // NOTE: restart the samples so all of the channels are mixed
+            for (size_t i = 0; i < SAMPLE_MIXER_CAPACITY; ++i) {
+                mixer.samples[i] = sample_s16_files[i % sample_s16_files_count].sample;
+                mixer.samples[i].audio_cur = 0;
+            }
+            sample_mixer_audio_callback(&mixer, (Uint8*) stream, (int) sizeof(stream));
+            bench_sink += (size_t) stream[0];
+        });
+    }
+
+    if (csv) {
+        print_results_csv(stdout);
+    } else {
+        print_results_json(stdout);
+    }
+
+    return 0;
+}
@@ -5,20 +5,43 @@ struct Camera
 {
     Vec2f pos;
     Vec2f vel;
+    // NOTE: log2 of the amount of screen pixels per world pixel, so the
+    // zero-initialized camera is 1:1, -1 shows twice as much of the
+    // world, 1 shows half as much.
+    float zoom;
 
-    Vec2f to_screen(Vec2f world_pos)
+    float scale() const
     {
-        return world_pos - (pos - vec2((float) SCREEN_WIDTH, (float) SCREEN_HEIGHT) * 0.5f);
+        return exp2f(zoom);
     }
 
-    Rectf to_screen(Rectf world_rect)
+    void zoom_by(float delta)
     {
-        return world_rect - (pos - vec2((float) SCREEN_WIDTH, (float) SCREEN_HEIGHT) * 0.5f);
+        zoom = clamp(zoom + delta, CAMERA_MIN_ZOOM, CAMERA_MAX_ZOOM);
     }
 
-    Vec2f to_world(Vec2f screen_pos)
+    Vec2f to_screen(Vec2f world_pos) const
     {
-        return screen_pos + (pos - vec2((float) SCREEN_WIDTH, (float) SCREEN_HEIGHT) * 0.5f);
+        return (world_pos - pos) * scale() + vec2((float) SCREEN_WIDTH, (float) SCREEN_HEIGHT) * 0.5f;
+    }
+
+    Rectf to_screen(Rectf world_rect) const
+    {
+        const float s = scale();
+        const Vec2f p = to_screen(vec2(world_rect.x, world_rect.y));
+        return rect(p, world_rect.w * s, world_rect.h * s);
+    }
+
+    Vec2f to_world(Vec2f screen_pos) const
+    {
+        return (screen_pos - vec2((float) SCREEN_WIDTH, (float) SCREEN_HEIGHT) * 0.5f) / scale() + pos;
+    }
+
+    // NOTE: the part of the world that is visible on the screen
+    Rectf view_rect() const
+    {
+        const float s = scale();
+        return rect(to_world(vec2(0.0f, 0.0f)), SCREEN_WIDTH / s, SCREEN_HEIGHT / s);
     }
 
     void update(float delta_time)
@@ -26,3 +49,11 @@ struct Camera
         pos += vel * delta_time;
     }
 };
+
+// NOTE: how many world objects were drawn and how many were skipped
+// because they were outside of the camera view
+struct Cull_Stats
+{
+    size_t drawn;
+    size_t culled;
+};
@@ -21,4 +21,33 @@ struct RGBA
 RGBA sdl_to_rgba(SDL_Color sdl_color);
 SDL_Color rgba_to_sdl(RGBA rgba);
 
+// NOTE: Packed color used on the render side. The config keeps
+// colors as RGBA and they are converted with rgba8() right where they
+// enter the rendering code, so the renderer never touches floats.
+struct RGBA8
+{
+    Uint8 r, g, b, a;
+};
+
+RGBA8 rgba8(RGBA rgba);
+// NOTE: multiplies the alpha of the color by `t` in [0, 1]
+RGBA8 rgba8_fade(RGBA8 color, float t);
+
+// NOTE: Batch conversions. They convert `n` colors at once with a
+// branchless formula that GCC vectorizes in the release build
+// (checked with -O3 -fno-trapping-math -fopt-info-vec).
+void hsla_to_rgba(const HSLA *hsla, RGBA *rgba, size_t n);
+void rgba_to_hsla(const RGBA *rgba, HSLA *hsla, size_t n);
+
+// NOTE: The hue LUT stores the fully saturated colors of the hue wheel
+// quantised to HUE_LUT_SIZE steps. Lightness and saturation are
+// applied on top of it without any quantisation since they are linear.
+// The loop is not vectorized (there are no gathers in SSE2), it trades
+// the per-channel math of hsla_to_rgba() for a table lookup.
+const size_t HUE_LUT_SIZE = 360;
+RGBA hue_lut[HUE_LUT_SIZE] = {};
+
+void init_hue_lut();
+void hsla_to_rgba_lut(const HSLA *hsla, RGBA *rgba, size_t n);
+
 #endif  // SOMETHING_COLOR_HPP_
@@ -110,18 +110,34 @@ void command_reload(Game *game, String_View)
     }
 }
 
+void command_trace(Game *game, String_View args)
+{
+    if (SDL_AtomicGet(&profiler.tracing)) {
+        game->console.println("Trace is already being captured");
+        return;
+    }
+
+    size_t frames_count = PROFILER_TRACE_DEFAULT_FRAMES;
+    args = args.trim();
+    if (args.count > 0) {
+        auto x = args.as_integer<int>();
+        if (!x.has_value || x.unwrap <= 0) {
+            game->console.println("`", args, "` is not a positive number of frames");
+            return;
+        }
+        frames_count = (size_t) x.unwrap;
+    }
+
+    profiler.start_trace(frames_count);
+    game->console.println("Capturing ", frames_count, " frames into `", PROFILER_TRACE_FILE_PATH, "`");
+}
+
 #endif // SOMETHING_RELEASE
 
 void command_save_room(Game *game, String_View)
 {
     auto &player = game->entities[PLAYER_ENTITY_INDEX];
-    Recti *lock = NULL;
-    for (size_t i = 0; i < game->camera_locks_count; ++i) {
-        Rectf lock_abs = rect_cast<float>(game->camera_locks[i]) * TILE_SIZE;
-        if (rect_contains_vec2(lock_abs, player.pos)) {
-            lock = &game->camera_locks[i];
-        }
-    }
+    Recti *lock = game->camera_lock_at(player.pos);
     if(lock) {
         size_t tile_index = 0;
         for (int y = lock->y; y < lock->y + ROOM_HEIGHT; ++y) {
@@ -150,6 +166,65 @@ void command_save_room(Game *game, String_View)
     }
 }
 
+void command_save_level(Game *game, String_View args)
+{
+    char filepath[256];
+    args = args.trim();
+    if (args.count > 0) {
+        snprintf(filepath, sizeof(filepath), "%.*s", (int) args.count, args.data);
+    } else {
+        snprintf(filepath, sizeof(filepath), "%s", LEVEL_FILE_PATH);
+    }
+
+    // NOTE: the rooms far away from the player are not on the grid
+    game->room_streamer.load_all(&game->grid, &game->room_index);
+
+    if (!game->grid.save_rooms_to_archive(filepath, game->camera_locks, game->camera_locks_count)) {
+        game->console.println("Could not save level to `", filepath, "`: ", strerror(errno));
+        return;
+    }
+
+    game->console.println("Saved ", game->camera_locks_count, " rooms to `", filepath, "`");
+}
+
+void command_load_level(Game *game, String_View args)
+{
+    char filepath[256];
+    args = args.trim();
+    if (args.count > 0) {
+        snprintf(filepath, sizeof(filepath), "%.*s", (int) args.count, args.data);
+    } else {
+        snprintf(filepath, sizeof(filepath), "%s", LEVEL_FILE_PATH);
+    }
+
+    auto file = map_file(filepath);
+    if (!file.has_value) {
+        game->console.println("Could not load level from `", filepath, "`: ", strerror(errno));
+        return;
+    }
+    defer(unmap_file(file.unwrap));
+
+    auto archive = parse_level_archive(file.unwrap.data, file.unwrap.size);
+    if (!archive.has_value) {
+        game->console.println("`", filepath, "` is not a valid level archive");
+        return;
+    }
+
+    // NOTE: the rooms of the archive are placed into the rooms of the
+    // current level in order. The streamer would bring the old rooms
+    // back, so from now on every room stays on the grid.
+    game->room_streamer.disable(&game->grid, &game->room_index);
+    const size_t rooms_count = min((size_t) archive.unwrap.header.rooms_count, game->camera_locks_count);
+    for (size_t i = 0; i < rooms_count; ++i) {
+        if (!game->grid.load_room_from_archive(&archive.unwrap, i, rect_top_left(game->camera_locks[i]))) {
+            game->console.println("Could not load room ", i, " from `", filepath, "`");
+            return;
+        }
+    }
+
+    game->console.println("Loaded ", rooms_count, " rooms from `", filepath, "`");
+}
+
 void command_history(Game *game, String_View)
 {
     game->console.println("--------------------");
@@ -163,3 +238,23 @@ void command_history(Game *game, String_View)
     }
     game->console.println("--------------------");
 }
+
+void command_stats(Game *game, String_View)
+{
+    const auto stats = game->frame_stats();
+    char text[CONSOLE_COLUMNS];
+
+    snprintf(text, sizeof(text), "Last %zu frames, budget %.1fms",
+             stats.frames_count, FRAME_BUDGET_MS);
+    game->console.println(text);
+    snprintf(text, sizeof(text), "Frame ms p50/p95/p99/max: %.2f/%.2f/%.2f/%.2f",
+             stats.p50 * 1000.0f, stats.p95 * 1000.0f,
+             stats.p99 * 1000.0f, stats.max * 1000.0f);
+    game->console.println(text);
+    snprintf(text, sizeof(text), "Update steps avg/max: %.2f/%zu",
+             stats.avg_update_steps, stats.max_update_steps);
+    game->console.println(text);
+    snprintf(text, sizeof(text), "Hitches: %zu recent, %zu total",
+             stats.hitches_count, game->frame_hitches_count);
+    game->console.println(text);
+}
@@ -11,10 +11,15 @@ void command_close(Game *game, String_View args);
 #ifndef SOMETHING_RELEASE
 void command_set(Game *game, String_View args);
 void command_reload(Game *game, String_View args);
+void command_trace(Game *game, String_View args);
 #endif // SOMETHING_RELEASE
 void command_save_room(Game *game, String_View args);
-Tile room_to_save[ROOM_WIDTH * ROOM_HEIGHT];
+Room_File_Tile room_to_save[ROOM_WIDTH * ROOM_HEIGHT];
+const char *const LEVEL_FILE_PATH = "./level.pack";
+void command_save_level(Game *game, String_View args);
+void command_load_level(Game *game, String_View args);
 void command_history(Game *game, String_View args);
+void command_stats(Game *game, String_View args);
 
 struct Command
 {
@@ -32,9 +37,13 @@ const Command commands[] = {
 #ifndef SOMETHING_RELEASE
     {"set"_sv,         "Set the value of a variable"_sv,      command_set},
     {"reload"_sv,      "Reloads the configuration file"_sv,   command_reload},
+    {"trace"_sv,       "Capture N frames into trace.json"_sv, command_trace},
 #endif // SOMETHING_RELEASE
     {"save_room"_sv,   "Save current room as new file"_sv,    command_save_room},
+    {"save_level"_sv,  "Save all rooms into [file].pack"_sv,  command_save_level},
+    {"load_level"_sv,  "Load all rooms from [file].pack"_sv,  command_load_level},
     {"history"_sv,     "Print the history of the Console"_sv, command_history},
+    {"stats"_sv,       "Print frame time statistics"_sv,      command_stats},
 };
 const size_t commands_count = sizeof(commands) / sizeof(commands[0]);
 
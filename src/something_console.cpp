@@ -19,8 +19,10 @@ void Console::render(SDL_Renderer *renderer, Bitmap_Font *font)
         for (int i = 0; i < min(CONSOLE_VISIBLE_ROWS, (int) count); ++i) {
             const auto index = mod(begin + count - 1 - i - scroll, CONSOLE_ROWS);
             const auto position = vec2(0.0f, console_y + (float)((CONSOLE_VISIBLE_ROWS - i - 1) * BITMAP_FONT_CHAR_HEIGHT * CONSOLE_FONT_SIZE));
-            font->render(renderer, position, vec2(CONSOLE_FONT_SIZE, CONSOLE_FONT_SIZE),
-                         FONT_DEBUG_COLOR, String_View {rows_count[index], rows[index]});
+            font->render_cached(renderer, &row_textures[index], position,
+                                vec2(CONSOLE_FONT_SIZE, CONSOLE_FONT_SIZE),
+                                rgba8(FONT_DEBUG_COLOR),
+                                String_View {rows_count[index], rows[index]});
         }
 
         // EDIT FIELD
@@ -28,6 +28,7 @@ struct Console
 
     char rows[CONSOLE_ROWS][CONSOLE_COLUMNS];
     size_t rows_count[CONSOLE_ROWS];
+    Text_Texture row_textures[CONSOLE_ROWS];
 
     size_t begin;
     size_t count;
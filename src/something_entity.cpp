@@ -29,9 +29,6 @@ void Entity::render(SDL_Renderer *renderer, Camera camera, RGBA shade) const
         SDL_FLIP_NONE :
         SDL_FLIP_HORIZONTAL;
 
-    // TODO(#185): should we use shade for the particles of an entity?
-    particles.render(renderer, camera);
-
     switch (state) {
     case Entity_State::Alive: {
         // Figuring out texbox
@@ -51,6 +48,10 @@ void Entity::render(SDL_Renderer *renderer, Camera camera, RGBA shade) const
             break;
         }
 
+        // NOTE: the live bar and the gun are drawn on top of all of the
+        // entities when the rendering is recorded
+        const auto entities_layer = render_buffer.layer;
+
         // Rendering Live Bar
         {
             const Rectf livebar_border = {
@@ -65,35 +66,16 @@ void Entity::render(SDL_Renderer *renderer, Camera camera, RGBA shade) const
                 ENTITY_LIVEBAR_WIDTH * percent,
                 ENTITY_LIVEBAR_HEIGHT
             };
+            RGBA8 livebar_color = rgba8(ENTITY_LIVEBAR_LOW_COLOR);
             if (percent > 0.75f) {
-                const SDL_Color entity_livebar_full_color = rgba_to_sdl(ENTITY_LIVEBAR_FULL_COLOR);
-                sec(SDL_SetRenderDrawColor(
-                        renderer,
-                        entity_livebar_full_color.r,
-                        entity_livebar_full_color.g,
-                        entity_livebar_full_color.b,
-                        entity_livebar_full_color.a));
+                livebar_color = rgba8(ENTITY_LIVEBAR_FULL_COLOR);
             } else if (0.25f < percent && percent < 0.75f) {
-                const SDL_Color entity_livebar_half_color = rgba_to_sdl(ENTITY_LIVEBAR_HALF_COLOR);
-                sec(SDL_SetRenderDrawColor(
-                        renderer,
-                        entity_livebar_half_color.r,
-                        entity_livebar_half_color.g,
-                        entity_livebar_half_color.b,
-                        entity_livebar_half_color.a));
-            } else {
-                const SDL_Color entity_livebar_low_color = rgba_to_sdl(ENTITY_LIVEBAR_LOW_COLOR);
-                sec(SDL_SetRenderDrawColor(
-                        renderer,
-                        entity_livebar_low_color.r,
-                        entity_livebar_low_color.g,
-                        entity_livebar_low_color.b,
-                        entity_livebar_low_color.a));
+                livebar_color = rgba8(ENTITY_LIVEBAR_HALF_COLOR);
             }
-            const auto rect_border = rectf_for_sdl(camera.to_screen(livebar_border));
-            sec(SDL_RenderDrawRect(renderer, &rect_border));
-            const auto rect_remain = rectf_for_sdl(camera.to_screen(livebar_remain));
-            sec(SDL_RenderFillRect(renderer, &rect_remain));
+            render_buffer.layer = Render_Layer::Entity_Overlay;
+            draw_rect(renderer, camera.to_screen(livebar_border), livebar_color);
+            fill_rect(renderer, camera.to_screen(livebar_remain), livebar_color);
+            render_buffer.layer = entities_layer;
         }
 
         RGBA effective_flash_color = flash_color;
@@ -103,23 +85,26 @@ void Entity::render(SDL_Renderer *renderer, Camera camera, RGBA shade) const
         switch (alive_state) {
         case Alive_State::Idle: {
             idle.render(renderer, camera.to_screen(texbox), flip,
-                        mix_colors(shade, effective_flash_color));
+                        rgba8(mix_colors(shade, effective_flash_color)));
         } break;
 
         case Alive_State::Walking: {
             walking.render(renderer, camera.to_screen(texbox), flip,
-                           mix_colors(shade, effective_flash_color));
+                           rgba8(mix_colors(shade, effective_flash_color)));
         } break;
         }
 
         // Render the gun
         // TODO(#59): Proper gun rendering
         Vec2f gun_begin = pos;
+        render_buffer.layer = Render_Layer::Entity_Overlay;
         render_line(
             renderer,
             camera.to_screen(gun_begin),
             camera.to_screen(gun_begin + normalize(gun_dir) * ENTITY_GUN_LENGTH),
-            {1.0f, 0.0f, 0.0f, 1.0f});
+            RGBA8 {255, 0, 0, 255});
+
+        render_buffer.layer = entities_layer;
     } break;
 
     case Entity_State::Poof: {
@@ -128,7 +113,7 @@ void Entity::render(SDL_Renderer *renderer, Camera camera, RGBA shade) const
         //   Previous animation implementation was capturing texture of last alive state.
         //   So if entity was shot in running pose it was squashing in this position.
         //   So there's no sudden graphical switch to idle texture.
-        idle.render(renderer, camera.to_screen(texbox), flip, shade);
+        idle.render(renderer, camera.to_screen(texbox), flip, rgba8(shade));
     } break;
 
     case Entity_State::Ded: {} break;
@@ -163,26 +148,11 @@ void Entity::render_debug(SDL_Renderer *renderer, Camera camera) const
 
 HSLA get_particle_color_for_tile(Tile_Grid *grid, Vec2f pos)
 {
-    const auto tile_sprite = tile_defs[*grid->tile_at_abs(pos + vec2(0.0f, TILE_SIZE * 0.5f))].top_texture;
-    const auto surface = surfaces[tile_sprite.texture_index.unwrap];
-    const auto x = rand() % tile_sprite.srcrect.w;
-    sec(SDL_LockSurface(surface));
-    HSLA result = {};
-    {
-        assert(surface->format->format == SDL_PIXELFORMAT_RGBA32);
-        const auto pixel = *(Uint32*) ((uint8_t *) surface->pixels + tile_sprite.srcrect.y * surface->pitch + (tile_sprite.srcrect.x + x) * sizeof(Uint32));
-        SDL_Color color = {};
-        SDL_GetRGBA(
-            pixel,
-            surface->format,
-            &color.r,
-            &color.g,
-            &color.b,
-            &color.a);
-        result = sdl_to_rgba(color).to_hsla();
+    const auto &tile_def = tile_defs[*grid->tile_at_abs(pos + vec2(0.0f, TILE_SIZE * 0.5f))];
+    if (tile_def.palette_size == 0) {
+        return {};
     }
-    SDL_UnlockSurface(surface);
-    return result;
+    return tile_def.palette[(size_t) rand() % tile_def.palette_size];
 }
 
 void Entity::update(float dt, Sample_Mixer *mixer, Tile_Grid *grid)
@@ -227,9 +197,7 @@ void Entity::update(float dt, Sample_Mixer *mixer, Tile_Grid *grid)
                 vel.y = ENTITY_GRAVITY * -0.6f;
                 mixer->play_sample(jump_samples[rand() % 2]);
                 if (ground(grid)) {
-                    for (int i = 0; i < ENTITY_JUMP_PARTICLE_BURST; ++i) {
-                        particles.push(rand_float_range(PARTICLE_JUMP_VEL_LOW, PARTICLE_JUMP_VEL_HIGH));
-                    }
+                    particles.burst((size_t) ENTITY_JUMP_PARTICLE_BURST, PARTICLE_JUMP_VEL_LOW, PARTICLE_JUMP_VEL_HIGH);
                 }
             }
             break;
@@ -15,26 +15,207 @@ SDL_Rect Bitmap_Font::char_rect(char x)
     }
 }
 
-void Bitmap_Font::render(SDL_Renderer *renderer, Vec2f position, Vec2f size, RGBA color, String_View sv)
+// NOTE: FNV-1a
+static uint64_t text_run_hash(SDL_Texture *bitmap, Vec2f size, String_View text)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    const auto feed = [&](const void *data, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            hash = (hash ^ ((const uint8_t *) data)[i]) * 1099511628211ULL;
+        }
+    };
+    feed(&bitmap, sizeof(bitmap));
+    feed(&size, sizeof(size));
+    feed(text.data, text.count);
+    return hash;
+}
+
+const Text_Run *Text_Run_Cache::get(SDL_Texture *bitmap, Vec2f size, String_View text)
 {
-    SDL_Color sdl_color = rgba_to_sdl(color);
-    sec(SDL_SetTextureColorMod(bitmap, sdl_color.r, sdl_color.g, sdl_color.b));
-    sec(SDL_SetTextureAlphaMod(bitmap, sdl_color.a));
+    const uint64_t hash = text_run_hash(bitmap, size, text);
 
-    for (int row = 0; sv.count > 0; ++row) {
-        auto line = sv.chop_by_delim('\n');
+    size_t index = hash % TEXT_RUN_CACHE_CAPACITY;
+    for (; runs[index].occupied; index = (index + 1) % TEXT_RUN_CACHE_CAPACITY) {
+        const auto run = &runs[index];
+        if (run->hash == hash &&
+            run->bitmap == bitmap &&
+            run->size.x == size.x && run->size.y == size.y &&
+            String_View {run->text.size, run->text.data} == text) {
+            return run;
+        }
+    }
+
+    if (count >= TEXT_RUN_CACHE_CAPACITY * 3 / 4) {
+        flush();
+        index = hash % TEXT_RUN_CACHE_CAPACITY;
+    }
+
+    auto run = &runs[index];
+    run->occupied = true;
+    run->hash = hash;
+    run->bitmap = bitmap;
+    run->size = size;
+    run->text.clear();
+    run->text.concat(text.data, text.count);
+    run->vertices.clear();
+    count += 1;
+
+    int bitmap_width = 0;
+    int bitmap_height = 0;
+    sec(SDL_QueryTexture(bitmap, NULL, NULL, &bitmap_width, &bitmap_height));
+
+    size_t lines_count = 0;
+    size_t longest_line = 0;
+    for (int row = 0; text.count > 0; ++row) {
+        auto line = text.chop_by_delim('\n');
+        lines_count += 1;
+        longest_line = max(longest_line, line.count);
 
         for (int col = 0; (size_t) col < line.count; ++col) {
-            const SDL_Rect src_rect = char_rect(line.data[col]);
-            const SDL_Rect dest_rect = {
-                (int) floorf(position.x + BITMAP_FONT_CHAR_WIDTH  * col * size.x),
-                (int) floorf(position.y + BITMAP_FONT_CHAR_HEIGHT * row * size.y),
-                (int) floorf(src_rect.w * size.x),
-                (int) floorf(src_rect.h * size.y)
+            const SDL_Rect src_rect = Bitmap_Font::char_rect(line.data[col]);
+
+            const float x0 = floorf(BITMAP_FONT_CHAR_WIDTH  * col * size.x);
+            const float y0 = floorf(BITMAP_FONT_CHAR_HEIGHT * row * size.y);
+            const float x1 = x0 + floorf(src_rect.w * size.x);
+            const float y1 = y0 + floorf(src_rect.h * size.y);
+
+            const float u0 = (float) src_rect.x / (float) bitmap_width;
+            const float v0 = (float) src_rect.y / (float) bitmap_height;
+            const float u1 = (float) (src_rect.x + src_rect.w) / (float) bitmap_width;
+            const float v1 = (float) (src_rect.y + src_rect.h) / (float) bitmap_height;
+
+            const SDL_Color white = {255, 255, 255, 255};
+            const SDL_Vertex quad[TEXT_RUN_GLYPH_VERTICES] = {
+                {{x0, y0}, white, {u0, v0}},
+                {{x1, y0}, white, {u1, v0}},
+                {{x0, y1}, white, {u0, v1}},
+                {{x0, y1}, white, {u0, v1}},
+                {{x1, y0}, white, {u1, v0}},
+                {{x1, y1}, white, {u1, v1}},
             };
-            sec(SDL_RenderCopy(renderer, bitmap, &src_rect, &dest_rect));
+            run->vertices.concat(quad, TEXT_RUN_GLYPH_VERTICES);
+        }
+    }
+
+    run->text_size = vec2((float) longest_line * BITMAP_FONT_CHAR_WIDTH * size.x,
+                          (float) lines_count * BITMAP_FONT_CHAR_HEIGHT * size.y);
+
+    return run;
+}
+
+void Text_Run_Cache::flush()
+{
+    for (size_t i = 0; i < TEXT_RUN_CACHE_CAPACITY; ++i) {
+        runs[i].occupied = false;
+    }
+    count = 0;
+}
+
+const Text_Run *Bitmap_Font::layout(Vec2f size, String_View sv)
+{
+    return text_run_cache.get(bitmap, size, sv);
+}
+
+// NOTE: scratch buffer for the vertices of the submitted runs
+Dynamic_Array<SDL_Vertex> text_run_vertices = {};
+
+void Bitmap_Font::render_run(SDL_Renderer *renderer, const Text_Run *run,
+                             const Vec2f *positions, const RGBA8 *colors, size_t count)
+{
+    if (run->vertices.size == 0) return;
+
+    text_run_vertices.clear();
+    text_run_vertices.reserve(run->vertices.size * count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const float x = floorf(positions[i].x);
+        const float y = floorf(positions[i].y);
+        const SDL_Color color = {colors[i].r, colors[i].g, colors[i].b, colors[i].a};
+
+        for (size_t j = 0; j < run->vertices.size; ++j) {
+            SDL_Vertex vertex = run->vertices.data[j];
+            vertex.position.x += x;
+            vertex.position.y += y;
+            vertex.color = color;
+            text_run_vertices.push(vertex);
         }
     }
+
+    render_geometry(renderer, bitmap, text_run_vertices.data, text_run_vertices.size);
+}
+
+void Bitmap_Font::render(SDL_Renderer *renderer, Vec2f position, Vec2f size, RGBA8 color, String_View sv)
+{
+    render_run(renderer, layout(size, sv), &position, &color, 1);
+}
+
+void Bitmap_Font::render_shadowed(SDL_Renderer *renderer,
+                                  Vec2f position, Vec2f shadow_offset, Vec2f size,
+                                  RGBA8 color, RGBA8 shadow_color,
+                                  String_View sv)
+{
+    const Vec2f positions[] = {position + shadow_offset, position};
+    const RGBA8 colors[] = {shadow_color, color};
+    render_run(renderer, layout(size, sv), positions, colors, 2);
+}
+
+void Bitmap_Font::render_cached(SDL_Renderer *renderer, Text_Texture *cache,
+                                Vec2f position, Vec2f size, RGBA8 color,
+                                String_View sv)
+{
+    const bool up_to_date =
+        cache->texture != nullptr &&
+        cache->generation == text_texture_generation &&
+        cache->size.x == size.x && cache->size.y == size.y &&
+        cache->color.r == color.r && cache->color.g == color.g &&
+        cache->color.b == color.b && cache->color.a == color.a &&
+        String_View {cache->text.size, cache->text.data} == sv;
+
+    if (!up_to_date) {
+        const auto run = layout(size, sv);
+        const int width = max((int) ceilf(run->text_size.x), 1);
+        const int height = max((int) ceilf(run->text_size.y), 1);
+
+        if (cache->texture == nullptr || cache->width != width || cache->height != height) {
+            if (cache->texture != nullptr) {
+                SDL_DestroyTexture(cache->texture);
+            }
+            cache->texture = sec(SDL_CreateTexture(renderer,
+                                                   SDL_PIXELFORMAT_RGBA32,
+                                                   SDL_TEXTUREACCESS_TARGET,
+                                                   width, height));
+            sec(SDL_SetTextureBlendMode(cache->texture, SDL_BLENDMODE_BLEND));
+            cache->width = width;
+            cache->height = height;
+        }
+
+        // NOTE: the glyphs of a run don't overlap, so the text can be
+        // baked as is
+        const auto bake = begin_bake(renderer, cache->texture);
+        const Vec2f origin = vec2(0.0f, 0.0f);
+        render_run(renderer, run, &origin, &color, 1);
+        end_bake(renderer, bake);
+
+        cache->generation = text_texture_generation;
+        cache->size = size;
+        cache->color = color;
+        cache->text.clear();
+        cache->text.concat(sv.data, sv.count);
+    }
+
+    const SDL_Rect src_rect = {0, 0, cache->width, cache->height};
+    const SDL_Rect dest_rect = {
+        (int) floorf(position.x),
+        (int) floorf(position.y),
+        cache->width,
+        cache->height
+    };
+    render_copy(renderer, cache->texture, &src_rect, &dest_rect, SDL_FLIP_NONE, RGBA8 {255, 255, 255, 255});
+}
+
+void Bitmap_Font::render(SDL_Renderer *renderer, Vec2f position, Vec2f size, RGBA color, String_View sv)
+{
+    render(renderer, position, size, rgba8(color), sv);
 }
 
 void Bitmap_Font::render(SDL_Renderer *renderer, Vec2f position, Vec2f size, RGBA color, const char *cstr)
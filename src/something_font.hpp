@@ -5,13 +5,81 @@ const int BITMAP_FONT_ROW_SIZE    = 18;
 const int BITMAP_FONT_CHAR_WIDTH  = 7;
 const int BITMAP_FONT_CHAR_HEIGHT = 9;
 
+// NOTE: every glyph of a Text_Run is two triangles
+const size_t TEXT_RUN_GLYPH_VERTICES = 6;
+const size_t TEXT_RUN_CACHE_CAPACITY = 256;
+
+// NOTE: a string laid out as glyph quads relative to its top left
+// corner. The vertices are white, the color and the position are applied
+// when the run is submitted, so fading or moving text does not invalidate
+// the run.
+struct Text_Run
+{
+    bool occupied;
+    uint64_t hash;
+    SDL_Texture *bitmap;
+    Vec2f size;
+    Dynamic_Array<char> text;
+
+    Dynamic_Array<SDL_Vertex> vertices;
+    Vec2f text_size;
+};
+
+// NOTE: open addressing hash table of the laid out strings. When it gets
+// 3/4 full it's flushed as a whole. The buffers of the flushed runs are
+// reused, so after the warm up the cache does not allocate.
+struct Text_Run_Cache
+{
+    Text_Run runs[TEXT_RUN_CACHE_CAPACITY];
+    size_t count;
+
+    // NOTE: the run is valid until the next call of get()
+    const Text_Run *get(SDL_Texture *bitmap, Vec2f size, String_View text);
+    void flush();
+};
+
+Text_Run_Cache text_run_cache = {};
+
+// NOTE: a string rendered into its own texture once. Meant for the strings
+// that don't change between frames (tooltips, console rows), so they are
+// drawn with a single SDL_RenderCopy.
+struct Text_Texture
+{
+    SDL_Texture *texture;
+    size_t generation;
+    Vec2f size;
+    RGBA8 color;
+    Dynamic_Array<char> text;
+    int width;
+    int height;
+};
+
+// NOTE: bumped when the content of the render targets is lost
+// (SDL_RENDER_TARGETS_RESET, SDL_RENDER_DEVICE_RESET) so every
+// Text_Texture is rendered again
+size_t text_texture_generation = 1;
+
 struct Bitmap_Font
 {
     SDL_Texture *bitmap;
 
+    void render(SDL_Renderer *renderer, Vec2f position, Vec2f size, RGBA8 color, String_View sv);
     void render(SDL_Renderer *renderer, Vec2f position, Vec2f size, RGBA color, String_View sv);
     void render(SDL_Renderer *renderer, Vec2f position, Vec2f size, RGBA color, const char *cstr);
-    SDL_Rect char_rect(char x);
+    // NOTE: renders the shadow and the text in a single draw call
+    void render_shadowed(SDL_Renderer *renderer,
+                         Vec2f position, Vec2f shadow_offset, Vec2f size,
+                         RGBA8 color, RGBA8 shadow_color,
+                         String_View sv);
+    void render_cached(SDL_Renderer *renderer, Text_Texture *cache,
+                       Vec2f position, Vec2f size, RGBA8 color,
+                       String_View sv);
+    static SDL_Rect char_rect(char x);
+
+    const Text_Run *layout(Vec2f size, String_View sv);
+    // NOTE: submits `count` copies of the run with a single SDL_RenderGeometry
+    void render_run(SDL_Renderer *renderer, const Text_Run *run,
+                    const Vec2f *positions, const RGBA8 *colors, size_t count);
 
     Vec2f text_size(Vec2f size, String_View sv);
     Vec2f text_size(Vec2f size, const char *cstr);
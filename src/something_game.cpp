@@ -12,6 +12,8 @@ const char *projectile_state_as_cstr(Projectile_State state)
     return "";
 }
 
+const size_t DISPLAYF_CAPACITY = 1024;
+
 template <typename ... Types>
 void displayf(SDL_Renderer *renderer,
               Bitmap_Font *font,
@@ -20,13 +22,16 @@ void displayf(SDL_Renderer *renderer,
               Vec2f p,
               Types... args)
 {
-    char text[256];
-    String_Buffer sbuffer = {256, text, 0};
+    const size_t mark = frame_arena.mark();
+    defer(frame_arena.reset(mark));
+
+    String_Buffer sbuffer = arena_string_buffer(&frame_arena, DISPLAYF_CAPACITY);
     sprintln(&sbuffer, args...);
 
     auto font_size = vec2(FONT_DEBUG_SIZE, FONT_DEBUG_SIZE);
-    font->render(renderer, p - vec2(2.0f, 2.0f), font_size, shadow_color, text);
-    font->render(renderer, p, font_size, color, text);
+    font->render_shadowed(renderer, p, vec2(-2.0f, -2.0f), font_size,
+                          rgba8(color), rgba8(shadow_color),
+                          cstr_as_string_view(sbuffer.data));
 }
 
 void Projectile::kill()
@@ -45,6 +50,13 @@ void Game::handle_event(SDL_Event *event)
         quit = true;
     } break;
 
+    case SDL_RENDER_TARGETS_RESET:
+    case SDL_RENDER_DEVICE_RESET: {
+        background.invalidate_caches();
+        room_lods.invalidate();
+        text_texture_generation += 1;
+    } break;
+
     case SDL_KEYDOWN: {
         switch (event->key.keysym.sym) {
         case SDLK_BACKQUOTE: {
@@ -61,6 +73,10 @@ void Game::handle_event(SDL_Event *event)
             bfs_debug = !bfs_debug;
         } break;
 
+        case SDLK_F4: {
+            profiler_debug = !profiler_debug;
+        } break;
+
         case SDLK_F5: {
             command_reload(this, ""_sv);
         } break;
@@ -181,62 +197,72 @@ void Game::handle_event(SDL_Event *event)
             } break;
             }
         } break;
+
+        case SDL_MOUSEWHEEL: {
+            camera.zoom_by((float) event->wheel.y * CAMERA_ZOOM_STEP);
+        } break;
         }
     }
 }
 
 void Game::update(float dt)
 {
+    PROFILE_ZONE("update");
+
+    // Room Streaming //////////////////////////////
+    {
+        PROFILE_ZONE("streaming");
+        room_streamer.update(&grid, &room_index, entities[PLAYER_ENTITY_INDEX].pos);
+    }
+
     // Update Player's gun direction //////////////////////////////
     int mouse_x, mouse_y;
     SDL_GetMouseState(&mouse_x, &mouse_y);
     entities[PLAYER_ENTITY_INDEX].point_gun_at(mouse_position);
 
     // Enemy AI //////////////////////////////
-    auto &player = entities[PLAYER_ENTITY_INDEX];
-    Recti *lock = NULL;
-    for (size_t i = 0; i < camera_locks_count; ++i) {
-        Rectf lock_abs = rect_cast<float>(camera_locks[i]) * TILE_SIZE;
-        if (rect_contains_vec2(lock_abs, player.pos)) {
-            lock = &camera_locks[i];
+    {
+        PROFILE_ZONE("AI");
+
+        auto &player = entities[PLAYER_ENTITY_INDEX];
+        Recti *lock = camera_lock_at(player.pos);
+
+        auto player_tile = grid.abs_to_tile_coord(player.pos);
+        if (lock) {
+            grid.bfs_to_tile(player_tile, lock);
         }
-    }
 
-    auto player_tile = grid.abs_to_tile_coord(player.pos);
-    if (lock) {
-        grid.bfs_to_tile(player_tile, lock);
-    }
-
-    if (!debug && lock) {
-        Rectf lock_abs = rect_cast<float>(*lock) * TILE_SIZE;
-        for (size_t i = ENEMY_ENTITY_INDEX_OFFSET; i < ENTITIES_COUNT; ++i) {
-            auto &enemy =  entities[i];
-            if (enemy.state == Entity_State::Alive) {
-                if (rect_contains_vec2(lock_abs, enemy.pos)) {
-                    if (grid.a_sees_b(enemy.pos, player.pos)) {
-                        enemy.stop();
-                        enemy.point_gun_at(player.pos);
-                        entity_shoot({i});
-                    } else {
-                        auto enemy_tile = grid.abs_to_tile_coord(enemy.pos);
-                        auto next = grid.next_in_bfs(enemy_tile, lock);
-                        if (next.has_value) {
-                            auto d = next.unwrap - enemy_tile;
-
-                            if (d.y < 0) {
-                                enemy.jump();
-                            }
-                            if (d.x > 0) {
-                                enemy.move(Entity::Right);
-                            }
-                            if (d.x < 0) {
-                                enemy.move(Entity::Left);
-                            }
-                            if (d.x == 0) {
+        if (!debug && lock) {
+            Rectf lock_abs = rect_cast<float>(*lock) * TILE_SIZE;
+            for (size_t i = ENEMY_ENTITY_INDEX_OFFSET; i < ENTITIES_COUNT; ++i) {
+                auto &enemy =  entities[i];
+                if (enemy.state == Entity_State::Alive) {
+                    if (rect_contains_vec2(lock_abs, enemy.pos)) {
+                        if (grid.a_sees_b(enemy.pos, player.pos)) {
+                            enemy.stop();
+                            enemy.point_gun_at(player.pos);
+                            entity_shoot({i});
+                        } else {
+                            auto enemy_tile = grid.abs_to_tile_coord(enemy.pos);
+                            auto next = grid.next_in_bfs(enemy_tile, lock);
+                            if (next.has_value) {
+                                auto d = next.unwrap - enemy_tile;
+
+                                if (d.y < 0) {
+                                    enemy.jump();
+                                }
+                                if (d.x > 0) {
+                                    enemy.move(Entity::Right);
+                                }
+                                if (d.x < 0) {
+                                    enemy.move(Entity::Left);
+                                }
+                                if (d.x == 0) {
+                                    enemy.stop();
+                                }
+                            } else {
                                 enemy.stop();
                             }
-                        } else {
-                            enemy.stop();
                         }
                     }
                 }
@@ -245,67 +271,52 @@ void Game::update(float dt)
     }
 
     // Update All Entities //////////////////////////////
-    for (size_t i = 0; i < ENTITIES_COUNT; ++i) {
-        entities[i].update(dt, &mixer, &grid);
-        entity_resolve_collision({i});
-        entities[i].has_jumped = false;
+    {
+        PROFILE_ZONE("entities");
+
+        for (size_t i = 0; i < ENTITIES_COUNT; ++i) {
+            // NOTE: the entities in the evicted rooms are frozen until
+            // their rooms are streamed back in
+            if (!room_streamer.is_resident(&room_index, entities[i].pos)) continue;
+
+            entities[i].update(dt, &mixer, &grid);
+            entity_resolve_collision({i});
+            entities[i].has_jumped = false;
+        }
     }
 
-    // Update All Projectiles //////////////////////////////
-    update_projectiles(dt);
+    // Update All Projectiles and their interaction with Entities ////
+    {
+        PROFILE_ZONE("projectiles");
+        update_projectiles(dt);
+    }
 
     // Update Items //////////////////////////////
     for (size_t i = 0; i < ITEMS_COUNT; ++i) {
         items[i].update(dt);
     }
 
-    // Entities/Projectiles interaction //////////////////////////////
-    for (size_t index = 0; index < PROJECTILES_COUNT; ++index) {
-        auto projectile = projectiles + index;
-        if (projectile->state != Projectile_State::Active) continue;
-
-        for (size_t entity_index = 0;
-             entity_index < ENTITIES_COUNT;
-             ++entity_index)
-        {
-            auto entity = entities + entity_index;
-
-            if (entity->state != Entity_State::Alive) continue;
-            if (entity_index == projectile->shooter.unwrap) continue;
-
-            if (rect_contains_vec2(entity->hitbox_world(), projectile->pos)) {
-                projectile->kill();
-                entity->lives -= ENTITY_PROJECTILE_DAMAGE;
-
-                mixer.play_sample(damage_enemy_sample);
-                if (entity->lives <= 0) {
-                    entity->kill();
-                    mixer.play_sample(kill_enemy_sample);
-                } else {
-                    entity->vel += normalize(projectile->vel) * ENTITY_PROJECTILE_KNOCKBACK;
-                    entity->flash(ENTITY_DAMAGE_FLASH_COLOR);
-                }
-            }
-        }
-    }
-
     // Entities/Items interaction
-    for (size_t index = 0; index < ITEMS_COUNT; ++index) {
-        auto item = items + index;
-        if (item->type == ITEM_HEALTH) {
-            for (size_t entity_index = 0;
-                 entity_index < ENTITIES_COUNT;
-                 ++entity_index)
-            {
-                auto entity = entities + entity_index;
-
-                if (entity->state == Entity_State::Alive) {
-                    if (rects_overlap(entity->hitbox_world(), item->hitbox_world())) {
-                        entity->lives = min(entity->lives + ITEM_HEALTH_POINTS, ENTITY_MAX_LIVES);
-                        entity->flash(ENTITY_HEAL_FLASH_COLOR);
-                        mixer.play_sample(item->sound);
-                        item->type = ITEM_NONE;
-                        break;
+    {
+        PROFILE_ZONE("interactions");
+
+        for (size_t index = 0; index < ITEMS_COUNT; ++index) {
+            auto item = items + index;
+            if (item->type == ITEM_HEALTH) {
+                for (size_t entity_index = 0;
+                     entity_index < ENTITIES_COUNT;
+                     ++entity_index)
+                {
+                    auto entity = entities + entity_index;
+
+                    if (entity->state == Entity_State::Alive) {
+                        if (rects_overlap(entity->hitbox_world(), item->hitbox_world())) {
+                            entity->lives = min(entity->lives + ITEM_HEALTH_POINTS, ENTITY_MAX_LIVES);
+                            entity->flash(ENTITY_HEAL_FLASH_COLOR);
+                            mixer.play_sample(item->sound);
+                            item->type = ITEM_NONE;
+                            break;
+                        }
                     }
                 }
             }
@@ -324,17 +335,20 @@ void Game::update(float dt)
     }
 
     // Camera "Physics" //////////////////////////////
-    const auto player_pos = entities[PLAYER_ENTITY_INDEX].pos;
-    camera.vel = (player_pos - camera.pos) * PLAYER_CAMERA_FORCE;
+    {
+        PROFILE_ZONE("camera");
 
-    for (size_t i = 0; i < camera_locks_count; ++i) {
-        Rectf lock_abs = rect_cast<float>(camera_locks[i]) * TILE_SIZE;
-        if (rect_contains_vec2(lock_abs, player_pos)) {
+        const auto player_pos = entities[PLAYER_ENTITY_INDEX].pos;
+        camera.vel = (player_pos - camera.pos) * PLAYER_CAMERA_FORCE;
+
+        Recti *lock = camera_lock_at(player_pos);
+        if (lock) {
+            Rectf lock_abs = rect_cast<float>(*lock) * TILE_SIZE;
             camera.vel += (rect_center(lock_abs) - camera.pos) * CENTER_CAMERA_FORCE;
         }
-    }
 
-    camera.update(dt);
+        camera.update(dt);
+    }
 
     // Popup //////////////////////////////
     popup.update(dt);
@@ -345,44 +359,129 @@ void Game::update(float dt)
 
 void Game::render(SDL_Renderer *renderer)
 {
-    Recti *lock = NULL;
-    for (size_t i = 0; i < camera_locks_count; ++i) {
-        Rectf lock_abs = rect_cast<float>(camera_locks[i]) * TILE_SIZE;
-        if (rect_contains_vec2(lock_abs, entities[PLAYER_ENTITY_INDEX].pos)) {
-            lock = &camera_locks[i];
-        }
-    }
+    PROFILE_ZONE("render");
+
+    Recti *lock = camera_lock_at(entities[PLAYER_ENTITY_INDEX].pos);
+
+    // NOTE: zoomed out far enough the tiles and the sprites are only a
+    // few pixels big, so the rooms are drawn from their baked textures
+    // and the entities as plain quads
+    const bool lod = camera.zoom < ROOM_LOD_ZOOM;
 
-    background.render(renderer, camera);
+    // NOTE: the world is recorded into the render buffer and submitted
+    // sorted by layer and texture before the overlays
+    render_buffer.begin(renderer);
+
+    {
+        PROFILE_ZONE("background");
+        render_buffer.layer = Render_Layer::Background;
+        background.render(renderer, camera);
+    }
 
     if (bfs_debug && lock) {
+        render_buffer.layer = Render_Layer::Debug_Bfs;
         grid.render_debug_bfs_overlay(
             renderer,
             &camera,
             lock);
     }
 
-    grid.render(renderer, camera, lock);
+    {
+        PROFILE_ZONE("grid");
+        render_buffer.layer = Render_Layer::Grid;
+        if (lod) {
+            room_lods.render(renderer, camera, &grid, &room_index, &room_streamer, lock);
+        } else {
+            grid.render(renderer, camera, lock);
+        }
+    }
 
+    // NOTE: the world objects are culled by their position, so the view
+    // is padded by the farthest an entity draws from its position to
+    // keep the partially visible ones: the largest texbox with the live
+    // bar above it, or the gun
+    cull_stats = {};
+    float cull_padding = fmaxf(ENTITY_LIVEBAR_WIDTH, ENTITY_GUN_LENGTH);
     for (size_t i = 0; i < ENTITIES_COUNT; ++i) {
-        // TODO(#106): display health bar differently for enemies in a different room
-        entities[i].render(renderer, camera);
+        if (entities[i].state != Entity_State::Ded) {
+            const float texbox_size = fmaxf(entities[i].texbox_local.w, entities[i].texbox_local.h);
+            cull_padding = fmaxf(cull_padding, texbox_size + ENTITY_LIVEBAR_HEIGHT + ENTITY_LIVEBAR_PADDING_BOTTOM);
+        }
     }
+    const Rectf view = rect_shrink(camera.view_rect(), -cull_padding);
 
-    render_projectiles(renderer, camera);
+    {
+        PROFILE_ZONE("entities");
+        for (size_t i = 0; i < ENTITIES_COUNT; ++i) {
+            // TODO(#185): should we use shade for the particles of an entity?
+            if (!lod) {
+                render_buffer.layer = Render_Layer::Particles;
+                entities[i].particles.render(renderer, camera, &cull_stats);
+            }
 
-    for (size_t i = 0; i < ITEMS_COUNT; ++i) {
-        if (items[i].type != ITEM_NONE) {
-            items[i].render(renderer, camera);
+            if (entities[i].state == Entity_State::Ded) continue;
+
+            if (!rect_contains_vec2(view, entities[i].pos)) {
+                cull_stats.culled += 1;
+                continue;
+            }
+            cull_stats.drawn += 1;
+
+            // TODO(#106): display health bar differently for enemies in a different room
+            render_buffer.layer = Render_Layer::Entities;
+            if (lod) {
+                fill_rect(renderer,
+                          camera.to_screen(entities[i].texbox_world()),
+                          rgba8(i == PLAYER_ENTITY_INDEX ? ROOM_LOD_PLAYER_COLOR : ROOM_LOD_ENEMY_COLOR));
+            } else {
+                entities[i].render(renderer, camera);
+            }
+        }
+    }
+
+    {
+        PROFILE_ZONE("projectiles");
+        render_buffer.layer = Render_Layer::Projectiles;
+        render_projectiles(renderer, camera, view);
+    }
+
+    {
+        PROFILE_ZONE("items");
+        render_buffer.layer = Render_Layer::Items;
+        for (size_t i = 0; i < ITEMS_COUNT; ++i) {
+            if (items[i].type != ITEM_NONE) {
+                if (!rect_contains_vec2(view, items[i].pos)) {
+                    cull_stats.culled += 1;
+                    continue;
+                }
+                cull_stats.drawn += 1;
+
+                items[i].render(renderer, camera);
+            }
         }
     }
 
-    if (fps_debug) {
-        render_fps_overlay(renderer);
+    {
+        PROFILE_ZONE("flush");
+        render_buffer.flush(renderer);
     }
 
-    popup.render(renderer);
-    console.render(renderer, &debug_font);
+    {
+        PROFILE_ZONE("overlays");
+
+        if (fps_debug) {
+            render_fps_overlay(renderer);
+        }
+
+#ifndef SOMETHING_RELEASE
+        if (profiler_debug) {
+            profiler.render(renderer, &debug_font);
+        }
+#endif // SOMETHING_RELEASE
+
+        popup.render(renderer);
+        console.render(renderer, &debug_font);
+    }
 }
 
 void Game::entity_shoot(Entity_Index entity_index)
@@ -439,9 +538,7 @@ void Game::entity_resolve_collision(Entity_Index entity_index)
                 const int IMPACT_THRESHOLD = 5;
                 if (abs(d.y) >= IMPACT_THRESHOLD && !entity->has_jumped) {
                     if (fabsf(entity->vel.y) > LANDING_PARTICLE_BURST_THRESHOLD) {
-                        for (int i = 0; i < ENTITY_JUMP_PARTICLE_BURST; ++i) {
-                            entity->particles.push(rand_float_range(PARTICLE_JUMP_VEL_LOW, fabsf(entity->vel.y) * 0.25f));
-                        }
+                        entity->particles.burst((size_t) ENTITY_JUMP_PARTICLE_BURST, PARTICLE_JUMP_VEL_LOW, fabsf(entity->vel.y) * 0.25f);
                     }
 
                     entity->vel.y = 0;
@@ -525,6 +622,61 @@ void Game::render_debug_overlay(SDL_Renderer *renderer, size_t fps)
              entities[PLAYER_ENTITY_INDEX].vel.x, " ",
              entities[PLAYER_ENTITY_INDEX].vel.y);
 
+    {
+        const auto stats = frame_stats();
+        char text[256];
+        snprintf(text, sizeof(text),
+                 "Frame ms p50/p95/p99/max: %.1f/%.1f/%.1f/%.1f",
+                 stats.p50 * 1000.0f, stats.p95 * 1000.0f,
+                 stats.p99 * 1000.0f, stats.max * 1000.0f);
+        displayf(renderer, &debug_font,
+                 FONT_DEBUG_COLOR,
+                 FONT_SHADOW_COLOR,
+                 vec2(PADDING, 6 * 50 + PADDING),
+                 text);
+        snprintf(text, sizeof(text),
+                 "Update steps avg/max: %.2f/%zu, hitches: %zu",
+                 stats.avg_update_steps, stats.max_update_steps,
+                 stats.hitches_count);
+        displayf(renderer, &debug_font,
+                 stats.hitches_count > 0 ? FONT_FAILURE_COLOR : FONT_DEBUG_COLOR,
+                 FONT_SHADOW_COLOR,
+                 vec2(PADDING, 7 * 50 + PADDING),
+                 text);
+    }
+
+    displayf(renderer, &debug_font,
+             FONT_DEBUG_COLOR,
+             FONT_SHADOW_COLOR,
+             vec2(PADDING, 8 * 50 + PADDING),
+             "Drawn/culled: ", cull_stats.drawn, "/", cull_stats.culled);
+    displayf(renderer, &debug_font,
+             FONT_DEBUG_COLOR,
+             FONT_SHADOW_COLOR,
+             vec2(PADDING, 9 * 50 + PADDING),
+             "Draw calls/texture switches/state changes: ",
+             render_buffer.stats.draw_calls, "/",
+             render_buffer.stats.texture_switches, "/",
+             render_buffer.stats.state_changes);
+    displayf(renderer, &debug_font,
+             FONT_DEBUG_COLOR,
+             FONT_SHADOW_COLOR,
+             vec2(PADDING, 10 * 50 + PADDING),
+             "Rooms resident/pending/loaded/evicted: ",
+             room_streamer.stats.resident, "/",
+             room_streamer.stats.pending, "/",
+             room_streamer.stats.loaded, "/",
+             room_streamer.stats.evicted);
+    displayf(renderer, &debug_font,
+             FONT_DEBUG_COLOR,
+             FONT_SHADOW_COLOR,
+             vec2(PADDING, 11 * 50 + PADDING),
+             "Zoom: ", camera.zoom,
+             ", LOD rooms drawn/baked/fallback: ",
+             room_lods.stats.drawn, "/",
+             room_lods.stats.baked, "/",
+             room_lods.stats.fallback);
+
     if (tracking_projectile.has_value) {
         auto projectile = projectiles[tracking_projectile.unwrap.unwrap];
         const float SECOND_COLUMN_OFFSET = 700.0f;
@@ -614,12 +766,79 @@ void Game::render_fps_overlay(SDL_Renderer *renderer) {
                     SCREEN_HEIGHT - PADDING - frame_delays[j] * SCALE),
                 BAR_WIDTH,
                 frame_delays[j] * SCALE),
-                {   clamp(       frame_delays[j] * 60.0f - 1.0f, 0.0f, 1.0f),
+                RGBA {
+                    clamp(       frame_delays[j] * 60.0f - 1.0f, 0.0f, 1.0f),
                     clamp(2.0f - frame_delays[j] * 60.0f       , 0.0f, 1.0f),
                     0, (float) i / (float) FPS_BARS_COUNT});
     }
 }
 
+void Game::record_frame(float frame_sec, size_t update_steps)
+{
+    frame_delays[frame_delays_begin] = frame_sec;
+    frame_update_steps[frame_delays_begin] = update_steps;
+    frame_delays_begin = (frame_delays_begin + 1) % FPS_BARS_COUNT;
+    frame_delays_count = min(frame_delays_count + 1, FPS_BARS_COUNT);
+
+    if (frame_sec * 1000.0f > FRAME_BUDGET_MS) {
+        frame_hitches_count += 1;
+
+        if (FRAME_HITCH_LOG) {
+            print(stderr, "[HITCH] ", frame_sec * 1000.0f, "ms > ", FRAME_BUDGET_MS, "ms, ",
+                  update_steps, " update steps");
+#ifndef SOMETHING_RELEASE
+            // NOTE: the main track has just published the frame that took too long
+            auto hotspot = profiler.hotspot(PROFILER_TRACK_MAIN);
+            if (hotspot.has_value) {
+                print(stderr, ", dominated by `", hotspot.unwrap.name, "` ",
+                      hotspot.unwrap.self_sec * 1000.0f, "ms");
+            }
+#endif // SOMETHING_RELEASE
+            println(stderr);
+        }
+    }
+}
+
+static int compare_floats(const void *a, const void *b)
+{
+    const float x = *(const float*) a;
+    const float y = *(const float*) b;
+    return (x > y) - (x < y);
+}
+
+Frame_Stats Game::frame_stats()
+{
+    Frame_Stats stats = {};
+    stats.frames_count = frame_delays_count;
+    if (frame_delays_count == 0) return stats;
+
+    float sorted[FPS_BARS_COUNT];
+    size_t update_steps_sum = 0;
+    for (size_t i = 0; i < frame_delays_count; ++i) {
+        const size_t j = mod(frame_delays_begin + FPS_BARS_COUNT - frame_delays_count + i, FPS_BARS_COUNT);
+        sorted[i] = frame_delays[j];
+        update_steps_sum += frame_update_steps[j];
+        stats.max_update_steps = max(stats.max_update_steps, frame_update_steps[j]);
+        if (frame_delays[j] * 1000.0f > FRAME_BUDGET_MS) {
+            stats.hitches_count += 1;
+        }
+    }
+    qsort(sorted, frame_delays_count, sizeof(sorted[0]), compare_floats);
+
+    // NOTE: nearest-rank percentile
+    const auto percentile = [&](float p) {
+        const size_t rank = (size_t) ceilf(p * (float) frame_delays_count);
+        return sorted[rank > 0 ? rank - 1 : 0];
+    };
+    stats.p50 = percentile(0.50f);
+    stats.p95 = percentile(0.95f);
+    stats.p99 = percentile(0.99f);
+    stats.max = sorted[frame_delays_count - 1];
+    stats.avg_update_steps = (float) update_steps_sum / (float) frame_delays_count;
+
+    return stats;
+}
+
 int Game::count_alive_projectiles(void)
 {
     int res = 0;
@@ -629,20 +848,28 @@ int Game::count_alive_projectiles(void)
     return res;
 }
 
-void Game::render_projectiles(SDL_Renderer *renderer, Camera camera)
+void Game::render_projectiles(SDL_Renderer *renderer, Camera camera, Rectf view)
 {
     for (size_t i = 0; i < PROJECTILES_COUNT; ++i) {
+        if (projectiles[i].state == Projectile_State::Ded) continue;
+
+        if (!rect_contains_vec2(view, projectiles[i].pos)) {
+            cull_stats.culled += 1;
+            continue;
+        }
+        cull_stats.drawn += 1;
+
         switch (projectiles[i].state) {
         case Projectile_State::Active: {
             projectiles[i].active_animat.render(
                 renderer,
-                camera.to_screen(projectiles[i].pos));
+                camera.to_screen(projectiles[i].active_animat.rect_centered_at(projectiles[i].pos)));
         } break;
 
         case Projectile_State::Poof: {
             projectiles[i].poof_animat.render(
                 renderer,
-                camera.to_screen(projectiles[i].pos));
+                camera.to_screen(projectiles[i].poof_animat.rect_centered_at(projectiles[i].pos)));
         } break;
 
         case Projectile_State::Ded: {} break;
@@ -655,19 +882,45 @@ void Game::update_projectiles(float dt)
     for (size_t i = 0; i < PROJECTILES_COUNT; ++i) {
         switch (projectiles[i].state) {
         case Projectile_State::Active: {
+            if (!room_streamer.is_resident(&room_index, projectiles[i].pos)) break;
+
             projectiles[i].active_animat.update(dt);
-            projectiles[i].pos += projectiles[i].vel * dt;
 
-            auto tile = grid.tile_at_abs(projectiles[i].pos);
-            if (tile && tile_defs[*tile].is_collidable) {
-                projectiles[i].kill();
-                if (TILE_DESTROYABLE_0 <= *tile && *tile < TILE_DESTROYABLE_3) {
-                    *tile += 1;
-                } else if (*tile == TILE_DESTROYABLE_3) {
-                    *tile = TILE_EMPTY;
+            // NOTE: the projectile is traced along the whole segment it
+            // travels during this tick rather than probed at its end
+            // point, so fast projectiles cannot tunnel through thin
+            // walls or small hitboxes. The earliest hit wins.
+            const Vec2f begin = projectiles[i].pos;
+            const Vec2f end = begin + projectiles[i].vel * dt;
+            float hit_t = 1.0f;
+
+            auto tile_hit = grid.trace_segment(begin, end);
+            if (tile_hit.has_value) {
+                hit_t = tile_hit.unwrap.t;
+            }
+
+            Maybe<Entity_Index> entity_hit = {};
+            for (size_t entity_index = 0; entity_index < ENTITIES_COUNT; ++entity_index) {
+                if (entities[entity_index].state != Entity_State::Alive) continue;
+                if (entity_index == projectiles[i].shooter.unwrap) continue;
+
+                auto t = segment_rect_intersection(begin, end, entities[entity_index].hitbox_world());
+                if (t.has_value && t.unwrap <= hit_t) {
+                    hit_t = t.unwrap;
+                    entity_hit = {true, {entity_index}};
                 }
             }
 
+            projectiles[i].pos = begin + (end - begin) * hit_t;
+
+            if (entity_hit.has_value) {
+                projectile_hit_entity({i}, entity_hit.unwrap);
+            } else if (tile_hit.has_value) {
+                projectiles[i].kill();
+                const auto coord = tile_hit.unwrap.coord;
+                grid.set_tile(coord, tile_props.hit_tile[grid.get_tile(coord)]);
+            }
+
             projectiles[i].lifetime -= dt;
 
             if (projectiles[i].lifetime <= 0.0f) {
@@ -688,6 +941,26 @@ void Game::update_projectiles(float dt)
     }
 }
 
+void Game::projectile_hit_entity(Projectile_Index projectile_index, Entity_Index entity_index)
+{
+    assert(projectile_index.unwrap < PROJECTILES_COUNT);
+    assert(entity_index.unwrap < ENTITIES_COUNT);
+    auto projectile = projectiles + projectile_index.unwrap;
+    auto entity = entities + entity_index.unwrap;
+
+    projectile->kill();
+    entity->lives -= ENTITY_PROJECTILE_DAMAGE;
+
+    mixer.play_sample(damage_enemy_sample);
+    if (entity->lives <= 0) {
+        entity->kill();
+        mixer.play_sample(kill_enemy_sample);
+    } else {
+        entity->vel += normalize(projectile->vel) * ENTITY_PROJECTILE_KNOCKBACK;
+        entity->flash(ENTITY_DAMAGE_FLASH_COLOR);
+    }
+}
+
 const float PROJECTILE_TRACKING_PADDING = 50.0f;
 
 Rectf Game::hitbox_of_projectile(Projectile_Index index)
@@ -725,10 +998,23 @@ void Game::spawn_health_at_mouse()
     }
 }
 
-void Game::add_camera_lock(Recti rect)
+Room_Id Game::add_camera_lock(Recti rect)
 {
     assert(camera_locks_count < CAMERA_LOCKS_CAPACITY);
+    const Room_Id id = room_index.add_room(rect);
+    assert(id == camera_locks_count);
     camera_locks[camera_locks_count++] = rect;
+    return id;
+}
+
+Recti *Game::camera_lock_at(Vec2f pos)
+{
+    const auto room = room_index.room_at_abs(pos);
+    if (room.has_value) {
+        return &camera_locks[room.unwrap];
+    }
+
+    return NULL;
 }
 
 void Game::spawn_enemy_at(Vec2f pos)
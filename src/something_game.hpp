@@ -5,6 +5,9 @@
 #include "something_particles.hpp"
 #include "something_texture.hpp"
 #include "something_background.hpp"
+#include "something_room_index.hpp"
+#include "something_room_streamer.hpp"
+#include "something_room_lod.hpp"
 
 enum Debug_Toolbar_Button
 {
@@ -66,10 +69,29 @@ const size_t PLAYER_ENTITY_INDEX = 0;
 const size_t ENTITIES_COUNT = 69;
 const size_t PROJECTILES_COUNT = 69;
 const size_t ITEMS_COUNT = 69;
-const size_t CAMERA_LOCKS_CAPACITY = 200;
+const size_t CAMERA_LOCKS_CAPACITY = ROOM_INDEX_CAPACITY;
 const size_t ROOM_ROW_COUNT = 8;
 const size_t FPS_BARS_COUNT = 256;
 
+// NOTE: Scratch memory for the data that lives only during a single
+// frame. The main loop resets it at the beginning of every frame, so
+// nothing allocated from it may be kept around for longer.
+const size_t FRAME_ARENA_CAPACITY = 4 * 1024 * 1024;
+char frame_arena_memory[FRAME_ARENA_CAPACITY];
+Arena frame_arena = {FRAME_ARENA_CAPACITY, frame_arena_memory, 0};
+
+struct Frame_Stats
+{
+    size_t frames_count;
+    float p50;
+    float p95;
+    float p99;
+    float max;
+    float avg_update_steps;
+    size_t max_update_steps;
+    size_t hitches_count;
+};
+
 struct Game
 {
     bool quit;
@@ -77,8 +99,12 @@ struct Game
     bool step_debug;
     bool bfs_debug;
     bool fps_debug;
+    bool profiler_debug;
     float frame_delays[FPS_BARS_COUNT];
+    size_t frame_update_steps[FPS_BARS_COUNT];
     size_t frame_delays_begin;
+    size_t frame_delays_count;
+    size_t frame_hitches_count;
 
     Vec2f collision_probe;
     Vec2f mouse_position;
@@ -116,10 +142,18 @@ struct Game
 
     Recti camera_locks[CAMERA_LOCKS_CAPACITY];
     size_t camera_locks_count;
+    // NOTE: ids of the rooms are the indices of camera_locks
+    Room_Index room_index;
+    Room_Streamer room_streamer;
+    Room_Lod_Cache room_lods;
 
     Background background;
 
-    void add_camera_lock(Recti rect);
+    // NOTE: world objects drawn and culled during the last render()
+    Cull_Stats cull_stats;
+
+    Room_Id add_camera_lock(Recti rect);
+    Recti *camera_lock_at(Vec2f pos);
 
     // Whole Game State
     void update(float dt);
@@ -128,6 +162,10 @@ struct Game
     void render_debug_overlay(SDL_Renderer *renderer, size_t fps);
     void render_fps_overlay(SDL_Renderer *renderer);
 
+    // Frame Stats of the Game
+    void record_frame(float frame_sec, size_t update_steps);
+    Frame_Stats frame_stats();
+
     // Entities of the Game
     void reset_entities();
     void entity_shoot(Entity_Index entity_index);
@@ -138,8 +176,9 @@ struct Game
     // Projectiles of the Game
     void spawn_projectile(Vec2f pos, Vec2f vel, Entity_Index shooter);
     int count_alive_projectiles(void);
-    void render_projectiles(SDL_Renderer *renderer, Camera camera);
+    void render_projectiles(SDL_Renderer *renderer, Camera camera, Rectf view);
     void update_projectiles(float dt);
+    void projectile_hit_entity(Projectile_Index projectile_index, Entity_Index entity_index);
     Rectf hitbox_of_projectile(Projectile_Index index);
     Maybe<Projectile_Index> projectile_at_position(Vec2f position);
 
@@ -5,12 +5,12 @@ void Item::update(float delta_time)
     a = fmodf(a + ITEM_OSC_FREQ * delta_time, 2 * PI);
 }
 
-void Item::render(SDL_Renderer *renderer, Camera camera, RGBA shade) const
+void Item::render(SDL_Renderer *renderer, Camera camera, RGBA8 shade) const
 {
     if (type != ITEM_NONE) {
         sprite.render(
             renderer,
-            camera.to_screen(pos + vec2(0.0f, sin(a) * ITEM_AMP_VALUE)),
+            camera.to_screen(sprite.rect_centered_at(pos + vec2(0.0f, sin(a) * ITEM_AMP_VALUE))),
             SDL_FLIP_NONE,
             shade);
     }
@@ -0,0 +1,107 @@
+#include "./something_level_archive.hpp"
+
+void rle_encode(const uint8_t *tiles, size_t tiles_count, Dynamic_Array<char> *output)
+{
+    size_t i = 0;
+    while (i < tiles_count) {
+        size_t count = 1;
+        while (i + count < tiles_count && count < 255 && tiles[i + count] == tiles[i]) {
+            count += 1;
+        }
+
+        output->push((char) count);
+        output->push((char) tiles[i]);
+        i += count;
+    }
+}
+
+bool rle_decode(const char *input, size_t input_size, uint8_t *tiles, size_t tiles_count)
+{
+    if (input_size % 2 != 0) return false;
+
+    size_t n = 0;
+    for (size_t i = 0; i < input_size; i += 2) {
+        const size_t count = (uint8_t) input[i];
+        if (count == 0 || n + count > tiles_count) return false;
+        memset(tiles + n, (uint8_t) input[i + 1], count);
+        n += count;
+    }
+
+    return n == tiles_count;
+}
+
+size_t Level_Archive::room_tiles_count() const
+{
+    return (size_t) header.room_width * (size_t) header.room_height;
+}
+
+bool Level_Archive::decode_room(size_t room_index, uint8_t *tiles) const
+{
+    assert(room_index < header.rooms_count);
+    const auto room = rooms[room_index];
+    return rle_decode(data + room.offset, room.size, tiles, room_tiles_count());
+}
+
+Maybe<Level_Archive> parse_level_archive(const char *data, size_t size)
+{
+    Level_Archive archive = {};
+    archive.data = data;
+    archive.size = size;
+
+    if (size < sizeof(archive.header)) return {};
+    memcpy(&archive.header, data, sizeof(archive.header));
+
+    if (memcmp(archive.header.magic, LEVEL_ARCHIVE_MAGIC, sizeof(LEVEL_ARCHIVE_MAGIC)) != 0) return {};
+    if (archive.header.version != LEVEL_ARCHIVE_VERSION) return {};
+
+    const size_t rooms_end = sizeof(archive.header) + archive.header.rooms_count * sizeof(Level_Archive_Room);
+    if (size < rooms_end) return {};
+    archive.rooms = (const Level_Archive_Room *) (data + sizeof(archive.header));
+
+    for (size_t i = 0; i < archive.header.rooms_count; ++i) {
+        const auto room = archive.rooms[i];
+        if (room.offset < rooms_end || (size_t) room.offset + room.size > size) return {};
+    }
+
+    return {true, archive};
+}
+
+bool save_level_archive(const char *filepath,
+                        uint16_t room_width, uint16_t room_height,
+                        const uint8_t *rooms, size_t rooms_count)
+{
+    Level_Archive_Header header = {};
+    memcpy(header.magic, LEVEL_ARCHIVE_MAGIC, sizeof(header.magic));
+    header.version = LEVEL_ARCHIVE_VERSION;
+    header.room_width = room_width;
+    header.room_height = room_height;
+    header.rooms_count = (uint32_t) rooms_count;
+
+    const size_t room_tiles_count = (size_t) room_width * (size_t) room_height;
+
+    Dynamic_Array<Level_Archive_Room> directory = {};
+    defer(directory.release());
+    directory.reserve(rooms_count);
+
+    Dynamic_Array<char> compressed = {};
+    defer(compressed.release());
+
+    const size_t rooms_begin = sizeof(header) + rooms_count * sizeof(Level_Archive_Room);
+    for (size_t i = 0; i < rooms_count; ++i) {
+        Level_Archive_Room room = {};
+        room.offset = (uint32_t) (rooms_begin + compressed.size);
+        rle_encode(rooms + i * room_tiles_count, room_tiles_count, &compressed);
+        room.size = (uint32_t) (rooms_begin + compressed.size - room.offset);
+        directory.push(room);
+    }
+
+    FILE *f = fopen(filepath, "wb");
+    if (f == NULL) return false;
+    defer(fclose(f));
+
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(directory.data, sizeof(directory.data[0]), directory.size, f);
+    fwrite(compressed.data, 1, compressed.size, f);
+
+    return !ferror(f);
+}
@@ -0,0 +1,59 @@
+#ifndef SOMETHING_LEVEL_ARCHIVE_HPP_
+#define SOMETHING_LEVEL_ARCHIVE_HPP_
+
+// NOTE: Level archive is a single file that packs several rooms:
+//
+//   Level_Archive_Header
+//   Level_Archive_Room[header.rooms_count]
+//   RLE compressed tiles of every room
+//
+// Every room is room_width * room_height tiles, one byte per tile,
+// row by row. The tiles are compressed as (count, tile) byte pairs
+// where count is in [1, 255]. All of the integers are stored in the
+// native byte order just like the raw room files.
+//
+// This file must not depend on SDL or the game so the packer can use it.
+
+const char LEVEL_ARCHIVE_MAGIC[4] = {'S', 'L', 'V', 'L'};
+const uint32_t LEVEL_ARCHIVE_VERSION = 1;
+
+struct Level_Archive_Header
+{
+    char magic[4];
+    uint32_t version;
+    uint16_t room_width;
+    uint16_t room_height;
+    uint32_t rooms_count;
+};
+
+struct Level_Archive_Room
+{
+    // NOTE: offset of the compressed tiles from the beginning of the archive
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct Level_Archive
+{
+    Level_Archive_Header header;
+    const Level_Archive_Room *rooms;
+    const char *data;
+    size_t size;
+
+    size_t room_tiles_count() const;
+    bool decode_room(size_t room_index, uint8_t *tiles) const;
+};
+
+// NOTE: does not copy `data`, it must outlive the archive
+Maybe<Level_Archive> parse_level_archive(const char *data, size_t size);
+
+// NOTE: `rooms` are rooms_count rooms of room_width * room_height tiles
+// each. On failure errno describes the reason.
+bool save_level_archive(const char *filepath,
+                        uint16_t room_width, uint16_t room_height,
+                        const uint8_t *rooms, size_t rooms_count);
+
+void rle_encode(const uint8_t *tiles, size_t tiles_count, Dynamic_Array<char> *output);
+bool rle_decode(const char *input, size_t input_size, uint8_t *tiles, size_t tiles_count);
+
+#endif  // SOMETHING_LEVEL_ARCHIVE_HPP_
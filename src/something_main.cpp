@@ -5,37 +5,12 @@ const float SIMULATION_DELTA_TIME = 1.0f / SIMULATION_FPS;
 
 Game game = {};
 
-Dynamic_Array<Dynamic_Array<char>> load_room_files_from_dir(const char *room_dir_path)
-{
-    Dynamic_Array<Dynamic_Array<char>> room_files = {};
-
-    DIR *rooms_dir = opendir(room_dir_path);
-    defer(closedir(rooms_dir));
-    if (rooms_dir == NULL) {
-        println(stderr, "Can't open asset folder: ", room_dir_path);
-        abort();
-    }
-
-    for (struct dirent *d = readdir(rooms_dir);
-         d != NULL;
-         d = readdir(rooms_dir))
-    {
-        if (*d->d_name == '.') continue;
-        Dynamic_Array<char> room_file = {};
-        room_file.concat(room_dir_path, strlen(room_dir_path));
-        room_file.concat(d->d_name, strlen(d->d_name));
-        room_file.push('\0');
-        room_files.push(room_file);
-    }
-
-    return room_files;
-}
-
 int main(int argc, char *argv[])
 {
     (void) argc;
     (void) argv;
 
+    const Uint64 startup_begin = SDL_GetPerformanceCounter();
     sec(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO));
 
     SDL_Window *window =
@@ -58,9 +33,8 @@ int main(int argc, char *argv[])
     // TODO(#8): replace fantasy_tiles.png with our own assets
     auto tileset_texture = texture_index_by_name("./assets/sprites/fantasy_tiles.png"_sv);
 
-    load_textures(renderer);
-    load_samples();
-    load_frame_animat_files();
+    init_hue_lut();
+    load_assets(renderer, startup_begin);
 
     game.mixer.volume = 0.2f;
     game.keyboard = SDL_GetKeyboardState(NULL);
@@ -68,39 +42,7 @@ int main(int argc, char *argv[])
     game.popup.font.bitmap = load_texture_from_bmp_file(renderer, "./assets/fonts/charmap-oldschool.bmp", {0, 0, 0, 255});
     game.debug_font.bitmap = game.popup.font.bitmap;
 
-    // TODO(#119): move tiles srcrect dimention to config.vars
-    //   That may require add a new type to the config file.
-    //   Might be a good opportunity to simplify adding new types to the system.
-    tile_defs[TILE_WALL].top_texture = {
-        {120, 128, 16, 16},
-        tileset_texture
-    };
-    tile_defs[TILE_WALL].bottom_texture = {
-        {120, 128 + 16, 16, 16},
-        tileset_texture
-    };
-    tile_defs[TILE_DESTROYABLE_0].top_texture = {
-        {208, 176, 16, 16},
-        tileset_texture,
-    };
-    tile_defs[TILE_DESTROYABLE_0].bottom_texture = tile_defs[TILE_DESTROYABLE_0].top_texture;
-    tile_defs[TILE_DESTROYABLE_1].top_texture = {
-        {208 + 16, 176, 16, 16},
-        tileset_texture,
-    };
-    tile_defs[TILE_DESTROYABLE_1].bottom_texture = tile_defs[TILE_DESTROYABLE_1].top_texture;
-
-    tile_defs[TILE_DESTROYABLE_2].top_texture = {
-        {208, 176 + 16, 16, 16},
-        tileset_texture,
-    };
-    tile_defs[TILE_DESTROYABLE_2].bottom_texture = tile_defs[TILE_DESTROYABLE_2].top_texture;
-
-    tile_defs[TILE_DESTROYABLE_3].top_texture = {
-        {208 + 16, 176 + 16, 16, 16},
-        tileset_texture,
-    };
-    tile_defs[TILE_DESTROYABLE_3].bottom_texture = tile_defs[TILE_DESTROYABLE_3].top_texture;
+    init_tile_defs(tileset_texture);
 
     game.background.layers[0] = sprite_from_texture_index(texture_index_by_name("./assets/sprites/parallax-forest-lights.png"_sv));
     game.background.layers[1] = sprite_from_texture_index(texture_index_by_name("./assets/sprites/parallax-forest-middle-trees.png"_sv));
@@ -130,6 +72,12 @@ int main(int argc, char *argv[])
     auto fmw = fmw_init(CONFIG_VARS_FILE_PATH);
 #endif // SOMETHING_RELEASE
 
+    // NOTE: the tile palettes are the last thing that reads the pixels
+    // of the textures on the CPU side
+    if (TEXTURE_RELEASE_SURFACES) {
+        release_texture_surfaces();
+    }
+
     static_assert(DEBUG_TOOLBAR_COUNT <= TOOLBAR_BUTTONS_CAPACITY);
     game.debug_toolbar.buttons_count = DEBUG_TOOLBAR_COUNT;
     game.debug_toolbar.buttons[DEBUG_TOOLBAR_TILES].icon = tile_defs[TILE_WALL].top_texture;
@@ -173,34 +121,86 @@ int main(int argc, char *argv[])
 
     game.reset_entities();
 
-    auto room_files = load_room_files_from_dir("./assets/rooms/");
+    // NOTE: the sources of the rooms stay mapped until the room
+    // streamer is stopped at the end of main(). The archive comes
+    // first, ./assets/rooms/ is only needed when the archive is missing
+    // or older than the rooms in there.
+    Maybe<Mapped_File> rooms_archive_file = map_file(ROOMS_ARCHIVE_FILE_PATH);
+    if (rooms_archive_file.has_value && is_rooms_archive_stale(ROOMS_ARCHIVE_FILE_PATH, "./assets/rooms/")) {
+        println(stderr, "[WARN] `", ROOMS_ARCHIVE_FILE_PATH, "` is older than the rooms in ./assets/rooms/. ",
+                "Loading the rooms from there instead. Run `make` to rebuild the archive.");
+        unmap_file(rooms_archive_file.unwrap);
+        rooms_archive_file = {};
+    }
+    defer(if (rooms_archive_file.has_value) unmap_file(rooms_archive_file.unwrap));
+    Maybe<Level_Archive> rooms_archive = {};
+    Dynamic_Array<Mapped_File> rooms = {};
+    defer(unmap_room_files(&rooms));
+
+    if (rooms_archive_file.has_value) {
+        rooms_archive = parse_level_archive(rooms_archive_file.unwrap.data, rooms_archive_file.unwrap.size);
+        if (!rooms_archive.has_value || rooms_archive.unwrap.header.rooms_count == 0) {
+            println(stderr, "`", ROOMS_ARCHIVE_FILE_PATH, "` is not a valid level archive");
+            abort();
+        }
+        game.room_streamer.source.archive = &rooms_archive.unwrap;
+    } else {
+        rooms = map_room_files(load_room_files_from_dir("./assets/rooms/"));
+        game.room_streamer.source.files = rooms.data;
+        game.room_streamer.source.files_count = rooms.size;
+    }
 
+    // NOTE: the rooms are only assigned to their places here. Only the
+    // rooms around the player are put on the grid right away, the rest
+    // are streamed in by the room streamer while the player moves.
     const int PADDING = 1;
+    const size_t source_rooms_count = game.room_streamer.source.count();
+    if (source_rooms_count == 0) {
+        println(stderr, "There are no rooms to build the level from");
+        abort();
+    }
     for (int y = 0; y < 10; ++y) {
         for (int x = 0; x < 10; ++x) {
             const auto coord = vec2(x * (ROOM_WIDTH + PADDING), y * (ROOM_HEIGHT + PADDING));
-            const size_t room_index = rand() % room_files.size;
-            game.grid.load_room_from_file(room_files.data[room_index].data, coord);
-            game.add_camera_lock(rect(coord, ROOM_WIDTH, ROOM_HEIGHT));
+            const Room_Id room = game.add_camera_lock(rect(coord, ROOM_WIDTH, ROOM_HEIGHT));
+            game.room_streamer.set_room_source(room, rand() % source_rooms_count);
         }
     }
 
+    game.room_streamer.load_around(&game.grid, &game.room_index, game.entities[PLAYER_ENTITY_INDEX].pos);
+    game.room_streamer.start();
+
     sec(SDL_SetRenderDrawBlendMode(
             renderer,
             SDL_BLENDMODE_BLEND));
 
-    Uint32 prev_ticks = SDL_GetTicks();
+    const float performance_frequency = (float) SDL_GetPerformanceFrequency();
+    Uint64 prev_counter = SDL_GetPerformanceCounter();
     float lag_sec = 0;
     float next_sec = 0;
     size_t frames_of_current_second = 0;
     size_t fps = 0;
+    size_t update_steps = 0;
+    bool first_frame_presented = false;
+    PROFILE_THREAD(PROFILER_TRACK_MAIN);
     while (!game.quit) {
-        Uint32 curr_ticks = SDL_GetTicks();
-        float elapsed_sec = (float) (curr_ticks - prev_ticks) / 1000.0f;
-        if(game.fps_debug) {
-            game.frame_delays[game.frame_delays_begin] = elapsed_sec;
-            game.frame_delays_begin = (game.frame_delays_begin + 1) % FPS_BARS_COUNT;
+#ifndef SOMETHING_RELEASE
+        if (profiler.update_trace()) {
+            if (profiler.save_trace(PROFILER_TRACE_FILE_PATH)) {
+                game.popup.notify(FONT_SUCCESS_COLOR, "Saved trace\n\n%s", PROFILER_TRACE_FILE_PATH);
+            } else {
+                game.popup.notify(FONT_FAILURE_COLOR, "Could not save trace\n\n%s", PROFILER_TRACE_FILE_PATH);
+            }
         }
+#endif // SOMETHING_RELEASE
+
+        PROFILE_ZONE("frame");
+        frame_arena.reset();
+
+        Uint64 curr_counter = SDL_GetPerformanceCounter();
+        float elapsed_sec = (float) (curr_counter - prev_counter) / performance_frequency;
+        game.record_frame(elapsed_sec, update_steps);
+        update_steps = 0;
 
         frames_of_current_second += 1;
         next_sec += elapsed_sec;
@@ -211,25 +211,29 @@ int main(int argc, char *argv[])
             frames_of_current_second = 0;
         }
 
-        prev_ticks = curr_ticks;
+        prev_counter = curr_counter;
         lag_sec += elapsed_sec;
 
         //// HANDLE INPUT //////////////////////////////
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            switch (event.type) {
-            case SDL_KEYDOWN: {
-                switch (event.key.keysym.sym) {
-                case SDLK_x: {
-                    if (game.step_debug) {
-                        game.update(SIMULATION_DELTA_TIME);
+        {
+            PROFILE_ZONE("input");
+
+            while (SDL_PollEvent(&event)) {
+                switch (event.type) {
+                case SDL_KEYDOWN: {
+                    switch (event.key.keysym.sym) {
+                    case SDLK_x: {
+                        if (game.step_debug) {
+                            game.update(SIMULATION_DELTA_TIME);
+                        }
+                    } break;
                     }
                 } break;
                 }
-            } break;
-            }
 
-            game.handle_event(&event);
+                game.handle_event(&event);
+            }
         }
 
 #ifndef SOMETHING_RELEASE
@@ -251,6 +255,7 @@ int main(int argc, char *argv[])
             while (lag_sec >= SIMULATION_DELTA_TIME) {
                 game.update(SIMULATION_DELTA_TIME);
                 lag_sec -= SIMULATION_DELTA_TIME;
+                update_steps += 1;
             }
         }
         //// UPDATE STATE END //////////////////////////////
@@ -279,10 +284,20 @@ int main(int argc, char *argv[])
         if (game.debug) {
             game.render_debug_overlay(renderer, fps);
         }
-        SDL_RenderPresent(renderer);
+        {
+            PROFILE_ZONE("present");
+            SDL_RenderPresent(renderer);
+        }
+
+        if (!first_frame_presented) {
+            first_frame_presented = true;
+            fprintf(stderr, "[STARTUP] first frame presented at %.2fms\n",
+                    (float) (SDL_GetPerformanceCounter() - startup_begin) * 1000.0f / performance_frequency);
+        }
         //// RENDER END //////////////////////////////
     }
 
+    game.room_streamer.stop();
     SDL_Quit();
 
     return 0;
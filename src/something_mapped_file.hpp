@@ -0,0 +1,17 @@
+#ifndef SOMETHING_MAPPED_FILE_HPP_
+#define SOMETHING_MAPPED_FILE_HPP_
+
+// NOTE: Read-only view of the whole content of a file. Depending on
+// the platform the file is either memory-mapped or read into memory.
+
+struct Mapped_File
+{
+    const char *data;
+    size_t size;
+};
+
+// NOTE: on failure errno describes the reason
+Maybe<Mapped_File> map_file(const char *filepath);
+void unmap_file(Mapped_File file);
+
+#endif  // SOMETHING_MAPPED_FILE_HPP_
@@ -0,0 +1,39 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "something_mapped_file.hpp"
+
+Maybe<Mapped_File> map_file(const char *filepath)
+{
+    int fd = open(filepath, O_RDONLY);
+    if (fd < 0) {
+        return {};
+    }
+    defer(close(fd));
+
+    struct stat file_stat = {};
+    if (fstat(fd, &file_stat) < 0) {
+        return {};
+    }
+
+    const size_t size = (size_t) file_stat.st_size;
+    if (size == 0) {
+        return {true, {nullptr, 0}};
+    }
+
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return {};
+    }
+
+    return {true, {(const char *) data, size}};
+}
+
+void unmap_file(Mapped_File file)
+{
+    if (file.data) {
+        munmap((void *) file.data, file.size);
+    }
+}
@@ -0,0 +1,36 @@
+#include "something_mapped_file.hpp"
+
+Maybe<Mapped_File> map_file(const char *filepath)
+{
+    FILE *f = fopen(filepath, "rb");
+    if (f == NULL) {
+        return {};
+    }
+    defer(fclose(f));
+
+    if (fseek(f, 0, SEEK_END) < 0) return {};
+    long size = ftell(f);
+    if (size < 0) return {};
+    if (fseek(f, 0, SEEK_SET) < 0) return {};
+
+    if (size == 0) {
+        return {true, {nullptr, 0}};
+    }
+
+    char *data = (char *) malloc((size_t) size);
+    if (data == NULL) {
+        return {};
+    }
+
+    if (fread(data, 1, (size_t) size, f) != (size_t) size) {
+        free(data);
+        return {};
+    }
+
+    return {true, {data, (size_t) size}};
+}
+
+void unmap_file(Mapped_File file)
+{
+    free((void *) file.data);
+}
@@ -218,6 +218,40 @@ bool rects_overlap(Rect<T> a, Rect<T> b)
     return !((a_x2 < b_x1) || (a_y2 < b_y1) || (b_x2 < a_x1) || (b_y2 < a_y1));
 }
 
+// NOTE: Returns the earliest t in [0, 1] such that a + (b - a) * t is
+// inside of the rect. Uses the slab method so thin rects are never
+// skipped no matter how long the segment is.
+Maybe<float> segment_rect_intersection(Vec2f a, Vec2f b, Rectf rect)
+{
+    const Vec2f d = b - a;
+    float t_enter = 0.0f;
+    float t_exit = 1.0f;
+
+    const float origin[2] = {a.x, a.y};
+    const float dir[2]    = {d.x, d.y};
+    const float low[2]    = {rect.x, rect.y};
+    const float high[2]   = {rect.x + rect.w, rect.y + rect.h};
+
+    for (int axis = 0; axis < 2; ++axis) {
+        if (fabsf(dir[axis]) < 1e-6f) {
+            if (origin[axis] < low[axis] || origin[axis] >= high[axis]) {
+                return {};
+            }
+        } else {
+            float t0 = (low[axis]  - origin[axis]) / dir[axis];
+            float t1 = (high[axis] - origin[axis]) / dir[axis];
+            if (t0 > t1) swap(&t0, &t1);
+            t_enter = fmaxf(t_enter, t0);
+            t_exit  = fminf(t_exit, t1);
+            if (t_enter > t_exit) {
+                return {};
+            }
+        }
+    }
+
+    return {true, t_enter};
+}
+
 Vec2f polar(float mag, float angle)
 {
     return vec2(cosf(angle), sinf(angle)) * mag;
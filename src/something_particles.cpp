@@ -1,17 +1,24 @@
 #include "something_color.hpp"
 #include "something_particles.hpp"
 
-void Particles::render(SDL_Renderer *renderer, Camera camera) const
+void Particles::render(SDL_Renderer *renderer, Camera camera, Cull_Stats *stats) const
 {
+    const Rectf view = camera.view_rect();
+
     for (size_t i = 0; i < count; ++i) {
         const size_t j = (begin + i) % PARTICLES_CAPACITY;
         if (lifetimes[j] > 0.0f) {
             const Rectf particle = rect(
                 positions[j] - vec2(sizes[j], sizes[j]) * 0.5f,
                 sizes[j], sizes[j]);
+            if (!rects_overlap(view, particle)) {
+                stats->culled += 1;
+                continue;
+            }
+            stats->drawn += 1;
+
             const auto opacity = lifetimes[j] / PARTICLE_LIFETIME;
-            fill_rect(renderer, camera.to_screen(particle),
-                      {colors[j].r, colors[j].g, colors[j].b, colors[j].a * opacity});
+            fill_rect(renderer, camera.to_screen(particle), rgba8_fade(colors[j], opacity));
         }
     }
 }
@@ -19,17 +26,41 @@ void Particles::render(SDL_Renderer *renderer, Camera camera) const
 
 void Particles::push(float impact)
 {
-    if (count < PARTICLES_CAPACITY) {
-        const size_t j = (begin + count) % PARTICLES_CAPACITY;
-        positions[j] = source;
-        velocities[j] = polar(impact, rand_float_range(PI, 2.0f * PI));
-        lifetimes[j] = PARTICLE_LIFETIME;
-        sizes[j] = rand_float_range(PARTICLE_SIZE_LOW, PARTICLE_SIZE_HIGH);
+    burst(1, impact, impact);
+}
+
+void Particles::burst(size_t n, float impact_low, float impact_high)
+{
+    HSLA hsla[PARTICLES_BATCH_CAPACITY];
+    RGBA rgba[PARTICLES_BATCH_CAPACITY];
+
+    n = min(n, PARTICLES_CAPACITY - count);
+    while (n > 0) {
+        const size_t batch_size = min(n, PARTICLES_BATCH_CAPACITY);
+
         // TODO(#187): implement HSL based generation of color for particles
-        HSLA hsla = current_color;
-        hsla.h += rand_float_range(0.0, 2.0 * PARTICLES_HUE_DEVIATION_DEGREE) - PARTICLES_HUE_DEVIATION_DEGREE;
-        colors[j] = hsla.to_rgba();
-        count += 1;
+        for (size_t i = 0; i < batch_size; ++i) {
+            hsla[i] = current_color;
+            hsla[i].h += rand_float_range(0.0, 2.0 * PARTICLES_HUE_DEVIATION_DEGREE) - PARTICLES_HUE_DEVIATION_DEGREE;
+        }
+
+        if (PARTICLES_HUE_LUT) {
+            hsla_to_rgba_lut(hsla, rgba, batch_size);
+        } else {
+            hsla_to_rgba(hsla, rgba, batch_size);
+        }
+
+        for (size_t i = 0; i < batch_size; ++i) {
+            const size_t j = (begin + count) % PARTICLES_CAPACITY;
+            positions[j] = source;
+            velocities[j] = polar(rand_float_range(impact_low, impact_high), rand_float_range(PI, 2.0f * PI));
+            lifetimes[j] = PARTICLE_LIFETIME;
+            sizes[j] = rand_float_range(PARTICLE_SIZE_LOW, PARTICLE_SIZE_HIGH);
+            colors[j] = rgba8(rgba[i]);
+            count += 1;
+        }
+
+        n -= batch_size;
     }
 }
 
@@ -2,6 +2,8 @@
 #define SOMETHING_PARTICLES_HPP_
 
 const size_t PARTICLES_CAPACITY = 1024;
+// NOTE: the amount of particles whose colors are converted at once
+const size_t PARTICLES_BATCH_CAPACITY = 64;
 
 struct Particles
 {
@@ -16,7 +18,7 @@ struct Particles
     Vec2f velocities[PARTICLES_CAPACITY];
     float lifetimes[PARTICLES_CAPACITY];
     float sizes[PARTICLES_CAPACITY];
-    RGBA colors[PARTICLES_CAPACITY];
+    RGBA8 colors[PARTICLES_CAPACITY];
     float cooldown;
     HSLA current_color;
     Vec2f source;
@@ -24,9 +26,10 @@ struct Particles
     size_t begin;
     size_t count;
 
-    void render(SDL_Renderer *renderer, Camera camera) const;
+    void render(SDL_Renderer *renderer, Camera camera, Cull_Stats *stats) const;
     void update(float dt, Tile_Grid *grid);
     void push(float impact);
+    void burst(size_t n, float impact_low, float impact_high);
     void pop();
 };
 
@@ -24,7 +24,8 @@ void Popup::render(SDL_Renderer *renderer)
 {
     if (buffer_size > 0 && a > 1e-6) {
         const auto font_size = vec2(FONT_POPUP_SIZE, FONT_POPUP_SIZE);
-        const auto text_size = font.text_size(font_size, buffer);
+        const auto run = font.layout(font_size, String_View {(size_t) buffer_size, buffer});
+        const auto text_size = run->text_size;
 
         const float alpha = fminf(a, 1.0f);
         const Vec2f position = vec2((float) SCREEN_WIDTH  * 0.5f - (float) text_size.x * 0.5f,
@@ -33,12 +34,14 @@ void Popup::render(SDL_Renderer *renderer)
         // SHADOW //////////////////////////////
         RGBA shadow_color = FONT_SHADOW_COLOR;
         shadow_color.a    = alpha;
-        font.render(renderer, position - shadow_offset_dir(0.5f), font_size, shadow_color, buffer);
 
         // TEXT   //////////////////////////////
         RGBA front_color = color;
-        color.a          = alpha;
-        font.render(renderer, position, font_size, front_color, buffer);
+        front_color.a    = alpha;
+
+        const Vec2f positions[] = {position - shadow_offset_dir(0.5f), position};
+        const RGBA8 colors[] = {rgba8(shadow_color), rgba8(front_color)};
+        font.render_run(renderer, run, positions, colors, 2);
     }
 }
 
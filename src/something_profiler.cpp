@@ -0,0 +1,255 @@
+#include "./something_profiler.hpp"
+
+void profiler_bind_thread(Profiler_Track_Id track_id)
+{
+    assert(track_id < PROFILER_TRACKS_COUNT);
+    profiler_track = &profiler.tracks[track_id];
+}
+
+void Profiler_Track::begin_zone(const char *name)
+{
+    if (stack_size >= PROFILER_STACK_CAPACITY) {
+        // NOTE: the zone is too deep. We still count it so
+        // the matching end_zone() does not unbalance the stack.
+        stack_size += 1;
+        return;
+    }
+
+    size_t index = PROFILER_ZONES_CAPACITY;
+    if (recording.zones_count < PROFILER_ZONES_CAPACITY) {
+        index = recording.zones_count++;
+        recording.zones[index].name = name;
+        recording.zones[index].depth = stack_size;
+        recording.zones[index].end = 0;
+        recording.zones[index].begin = SDL_GetPerformanceCounter();
+    }
+
+    stack[stack_size++] = index;
+}
+
+void Profiler_Track::end_zone()
+{
+    assert(stack_size > 0);
+    const Uint64 end = SDL_GetPerformanceCounter();
+
+    stack_size -= 1;
+    if (stack_size < PROFILER_STACK_CAPACITY) {
+        const size_t index = stack[stack_size];
+        if (index < PROFILER_ZONES_CAPACITY) {
+            recording.zones[index].end = end;
+        }
+    }
+
+    if (stack_size == 0) {
+        publish();
+    }
+}
+
+void Profiler_Track::publish()
+{
+    SDL_AtomicAdd(&published_seq, 1);
+    memcpy(published.zones, recording.zones, recording.zones_count * sizeof(recording.zones[0]));
+    published.zones_count = recording.zones_count;
+    SDL_AtomicAdd(&published_seq, 1);
+
+    // NOTE: `trace_writing` is set before `tracing` is checked, and
+    // update_trace() clears `tracing` before it checks `trace_writing`,
+    // so either this publish() sees the trace stopped or the main thread
+    // waits for it to finish.
+    SDL_AtomicSet(&trace_writing, 1);
+    if (SDL_AtomicGet(&profiler.tracing)) {
+        const size_t begin = (size_t) SDL_AtomicGet(&trace_count);
+        for (size_t i = 0; i < recording.zones_count; ++i) {
+            auto event = &trace[(begin + i) % PROFILER_TRACE_CAPACITY];
+            event->name = recording.zones[i].name;
+            event->begin = recording.zones[i].begin;
+            event->end = recording.zones[i].end;
+        }
+        SDL_AtomicAdd(&trace_count, (int) recording.zones_count);
+    }
+    SDL_AtomicSet(&trace_writing, 0);
+
+    recording.zones_count = 0;
+}
+
+void Profiler_Track::snapshot(Profiler_Frame *frame)
+{
+    for (;;) {
+        const int seq0 = SDL_AtomicGet(&published_seq);
+        if (seq0 % 2 != 0) continue;
+
+        frame->zones_count = published.zones_count;
+        memcpy(frame->zones, published.zones, frame->zones_count * sizeof(frame->zones[0]));
+
+        const int seq1 = SDL_AtomicGet(&published_seq);
+        if (seq0 == seq1) return;
+    }
+}
+
+void Profiler::render(SDL_Renderer *renderer, Bitmap_Font *font)
+{
+    const float PADDING = 20.0f;
+    const float ROW_HEIGHT = 30.0f;
+    const float TEXT_SIZE = 2.0f;
+    // NOTE: the whole width of the overlay corresponds to two frames
+    // of 60 FPS, so a frame that fits the budget takes half of it.
+    const float WINDOW_SEC = 2.0f / 60.0f;
+    const float WIDTH = SCREEN_WIDTH - PADDING * 2.0f;
+
+    const float frequency = (float) SDL_GetPerformanceFrequency();
+    const auto font_size = vec2(TEXT_SIZE, TEXT_SIZE);
+    const float char_width = BITMAP_FONT_CHAR_WIDTH * TEXT_SIZE;
+
+    // NOTE: static to keep the 8KB frame off the stack
+    static Profiler_Frame frame = {};
+    char label[64];
+
+    float y = SCREEN_HEIGHT * 0.5f;
+    for (size_t track = 0; track < PROFILER_TRACKS_COUNT; ++track) {
+        tracks[track].snapshot(&frame);
+        if (frame.zones_count == 0) continue;
+
+        const Uint64 origin = frame.zones[0].begin;
+        const float total_sec = (float) (frame.zones[0].end - origin) / frequency;
+
+        size_t max_depth = 0;
+        for (size_t i = 0; i < frame.zones_count; ++i) {
+            max_depth = max(max_depth, frame.zones[i].depth);
+        }
+
+        fill_rect(renderer,
+                  rect(vec2(PADDING, y), WIDTH, ROW_HEIGHT * (float) (max_depth + 2)),
+                  RGBA {0.0f, 0.0f, 0.0f, 0.7f});
+
+        snprintf(label, sizeof(label), "%s: %.2fms", profiler_track_names[track], total_sec * 1000.0f);
+        font->render(renderer, vec2(PADDING, y), font_size, FONT_DEBUG_COLOR, label);
+        y += ROW_HEIGHT;
+
+        for (size_t i = 0; i < frame.zones_count; ++i) {
+            const auto &zone = frame.zones[i];
+            const float begin_sec = (float) (zone.begin - origin) / frequency;
+            const float duration_sec = (float) (zone.end - zone.begin) / frequency;
+
+            const Rectf bar = rect(
+                vec2(PADDING + WIDTH * begin_sec / WINDOW_SEC,
+                     y + ROW_HEIGHT * (float) zone.depth),
+                fmaxf(WIDTH * duration_sec / WINDOW_SEC, 1.0f),
+                ROW_HEIGHT - 2.0f);
+
+            const HSLA color = {fmodf((float) i * 47.0f, 360.0f), 0.6f, 0.4f, 0.9f};
+            fill_rect(renderer, bar, color.to_rgba());
+
+            const int n = snprintf(label, sizeof(label), "%s %.2f", zone.name, duration_sec * 1000.0f);
+            const size_t fits = (size_t) (bar.w / char_width);
+            if (n > 0 && fits > 0) {
+                font->render(renderer, vec2(bar.x + 2.0f, bar.y + 2.0f), font_size,
+                             FONT_DEBUG_COLOR,
+                             String_View {min((size_t) n, fits), label});
+            }
+        }
+
+        y += ROW_HEIGHT * (float) (max_depth + 1);
+    }
+}
+
+Maybe<Profiler_Hotspot> Profiler::hotspot(Profiler_Track_Id track_id)
+{
+    assert(track_id < PROFILER_TRACKS_COUNT);
+
+    static Profiler_Frame frame = {};
+    tracks[track_id].snapshot(&frame);
+
+    const float frequency = (float) SDL_GetPerformanceFrequency();
+    Maybe<Profiler_Hotspot> result = {};
+    for (size_t i = 0; i < frame.zones_count; ++i) {
+        Uint64 self = frame.zones[i].end - frame.zones[i].begin;
+        for (size_t j = i + 1;
+             j < frame.zones_count && frame.zones[j].depth > frame.zones[i].depth;
+             ++j)
+        {
+            if (frame.zones[j].depth == frame.zones[i].depth + 1) {
+                self -= frame.zones[j].end - frame.zones[j].begin;
+            }
+        }
+
+        const float self_sec = (float) self / frequency;
+        if (!result.has_value || self_sec > result.unwrap.self_sec) {
+            result = {true, {frame.zones[i].name, self_sec}};
+        }
+    }
+
+    return result;
+}
+
+void Profiler::start_trace(size_t frames_count)
+{
+    assert(!SDL_AtomicGet(&tracing));
+
+    for (size_t i = 0; i < PROFILER_TRACKS_COUNT; ++i) {
+        SDL_AtomicSet(&tracks[i].trace_count, 0);
+    }
+
+    trace_frames_left = frames_count;
+    trace_begin = SDL_GetPerformanceCounter();
+    SDL_AtomicSet(&tracing, 1);
+}
+
+bool Profiler::update_trace()
+{
+    if (!SDL_AtomicGet(&tracing)) return false;
+
+    if (trace_frames_left > 0) {
+        trace_frames_left -= 1;
+    }
+
+    if (trace_frames_left == 0) {
+        SDL_AtomicSet(&tracing, 0);
+
+        // NOTE: the other threads may still be in the middle of
+        // publish(). It's only a copy of one frame of zones, so it's
+        // fine to spin.
+        for (size_t i = 0; i < PROFILER_TRACKS_COUNT; ++i) {
+            while (SDL_AtomicGet(&tracks[i].trace_writing)) {}
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// NOTE: https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+bool Profiler::save_trace(const char *file_path)
+{
+    FILE *f = fopen(file_path, "wb");
+    if (f == NULL) {
+        println(stderr, "Could not save trace to `", file_path, "`: ", strerror(errno));
+        return false;
+    }
+    defer(fclose(f));
+
+    const double us_per_tick = 1000000.0 / (double) SDL_GetPerformanceFrequency();
+
+    fprintf(f, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (size_t track = 0; track < PROFILER_TRACKS_COUNT; ++track) {
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", track, profiler_track_names[track]);
+        first = false;
+
+        const size_t count = (size_t) SDL_AtomicGet(&tracks[track].trace_count);
+        const size_t begin = count > PROFILER_TRACE_CAPACITY ? count - PROFILER_TRACE_CAPACITY : 0;
+        for (size_t i = begin; i < count; ++i) {
+            const auto &event = tracks[track].trace[i % PROFILER_TRACE_CAPACITY];
+            if (event.begin < trace_begin) continue;
+
+            fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.name, track,
+                    (double) (event.begin - trace_begin) * us_per_tick,
+                    (double) (event.end - event.begin) * us_per_tick);
+        }
+    }
+    fprintf(f, "\n]}\n");
+
+    return true;
+}
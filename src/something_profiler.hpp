@@ -0,0 +1,142 @@
+#ifndef SOMETHING_PROFILER_HPP_
+#define SOMETHING_PROFILER_HPP_
+
+#ifndef SOMETHING_RELEASE
+
+const size_t PROFILER_ZONES_CAPACITY = 256;
+const size_t PROFILER_STACK_CAPACITY = 32;
+const size_t PROFILER_TRACE_CAPACITY = 64 * 1024;
+const size_t PROFILER_TRACE_DEFAULT_FRAMES = 300;
+const char *const PROFILER_TRACE_FILE_PATH = "./trace.json";
+
+enum Profiler_Track_Id
+{
+    PROFILER_TRACK_MAIN = 0,
+    PROFILER_TRACK_AUDIO,
+    PROFILER_TRACK_STREAMING,
+    PROFILER_TRACKS_COUNT
+};
+
+const char *profiler_track_names[PROFILER_TRACKS_COUNT] = {
+    "main",                     // PROFILER_TRACK_MAIN
+    "audio",                    // PROFILER_TRACK_AUDIO
+    "streaming",                // PROFILER_TRACK_STREAMING
+};
+
+struct Profiler_Zone
+{
+    const char *name;
+    Uint64 begin;
+    Uint64 end;
+    size_t depth;
+};
+
+struct Profiler_Trace_Event
+{
+    const char *name;
+    Uint64 begin;
+    Uint64 end;
+};
+
+struct Profiler_Frame
+{
+    Profiler_Zone zones[PROFILER_ZONES_CAPACITY];
+    size_t zones_count;
+};
+
+// NOTE: the zone with the biggest self time (its duration without
+// the durations of its children) of a frame
+struct Profiler_Hotspot
+{
+    const char *name;
+    float self_sec;
+};
+
+// NOTE: A track is a timeline of zones recorded by a single
+// thread. Every time the outermost zone of the track is closed the
+// recorded frame is published so the main thread can display it.
+struct Profiler_Track
+{
+    Profiler_Frame recording;
+    size_t stack[PROFILER_STACK_CAPACITY];
+    size_t stack_size;
+
+    // NOTE: `published` is written by the thread that owns the track
+    // and read by the main thread. It is guarded by a seqlock:
+    // `published_seq` is odd while the frame is being copied.
+    SDL_atomic_t published_seq;
+    Profiler_Frame published;
+
+    // NOTE: Preallocated ring of zones recorded while a trace is being
+    // captured. Written only by the thread that owns the track;
+    // `trace_count` is the total amount of events ever written and is
+    // bumped after the events are in place.
+    Profiler_Trace_Event trace[PROFILER_TRACE_CAPACITY];
+    SDL_atomic_t trace_count;
+    // NOTE: 1 while publish() may be writing into `trace`. Lets the
+    // main thread wait for the owner of the track to let go of the
+    // ring after the trace is stopped.
+    SDL_atomic_t trace_writing;
+
+    void begin_zone(const char *name);
+    void end_zone();
+    void publish();
+    void snapshot(Profiler_Frame *frame);
+};
+
+struct Profiler
+{
+    Profiler_Track tracks[PROFILER_TRACKS_COUNT];
+
+    SDL_atomic_t tracing;
+    size_t trace_frames_left;
+    Uint64 trace_begin;
+
+    void render(SDL_Renderer *renderer, Bitmap_Font *font);
+    Maybe<Profiler_Hotspot> hotspot(Profiler_Track_Id track_id);
+
+    void start_trace(size_t frames_count);
+    // NOTE: must be called by the main thread once per frame outside of
+    // any zone. Returns true when the requested amount of frames has
+    // been captured and none of the tracks is writing into its trace
+    // anymore, so the trace is ready to be saved.
+    bool update_trace();
+    bool save_trace(const char *file_path);
+};
+
+Profiler profiler = {};
+
+// NOTE: Every thread that records zones must be bound to its track
+// first. Zones of unbound threads are ignored.
+thread_local Profiler_Track *profiler_track = nullptr;
+
+void profiler_bind_thread(Profiler_Track_Id track_id);
+
+struct Profiler_Scope
+{
+    Profiler_Track *track;
+
+    Profiler_Scope(const char *name): track(profiler_track)
+    {
+        if (track) track->begin_zone(name);
+    }
+
+    ~Profiler_Scope()
+    {
+        if (track) track->end_zone();
+    }
+};
+
+#define PROFILER_CONCAT_1(x, y) x##y
+#define PROFILER_CONCAT_2(x, y) PROFILER_CONCAT_1(x, y)
+#define PROFILE_ZONE(name) Profiler_Scope PROFILER_CONCAT_2(_profiler_scope_, __COUNTER__)(name)
+#define PROFILE_THREAD(track_id) profiler_bind_thread(track_id)
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_THREAD(track_id)
+
+#endif // SOMETHING_RELEASE
+
+#endif  // SOMETHING_PROFILER_HPP_
@@ -1,9 +1,307 @@
 #include "something_render.hpp"
 
+void Render_Buffer::begin(SDL_Renderer *renderer)
+{
+    recording = true;
+    layer = Render_Layer::Background;
+    pass = 0;
+    sec(SDL_GetRenderDrawBlendMode(renderer, &draw_blend));
+    commands.clear();
+    vertices.clear();
+}
+
+void Render_Buffer::push(Render_Command command)
+{
+    command.layer = layer;
+    command.pass = pass;
+    command.order = commands.size;
+    if (command.texture != nullptr) {
+        sec(SDL_GetTextureBlendMode(command.texture, &command.blend));
+    } else {
+        command.blend = draw_blend;
+    }
+    commands.push(command);
+}
+
+bool render_layer_is_sortable(Render_Layer layer)
+{
+    switch (layer) {
+    case Render_Layer::Debug_Bfs:
+    case Render_Layer::Grid:
+        return true;
+
+    case Render_Layer::Background:
+    case Render_Layer::Particles:
+    case Render_Layer::Entities:
+    case Render_Layer::Projectiles:
+    case Render_Layer::Items:
+    case Render_Layer::Entity_Overlay:
+        return false;
+    }
+
+    return false;
+}
+
+static int compare_render_commands(const void *a, const void *b)
+{
+    const auto x = (const Render_Command *) a;
+    const auto y = (const Render_Command *) b;
+
+    if (x->layer != y->layer) return (int) x->layer < (int) y->layer ? -1 : 1;
+    if (render_layer_is_sortable(x->layer)) {
+        if (x->pass != y->pass) return x->pass < y->pass ? -1 : 1;
+        if (x->texture != y->texture) return (uintptr_t) x->texture < (uintptr_t) y->texture ? -1 : 1;
+    }
+    if (x->order != y->order) return x->order < y->order ? -1 : 1;
+    return 0;
+}
+
+static bool rgba8_equal(RGBA8 a, RGBA8 b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+// NOTE: scratch buffers for merging the consecutive commands into a
+// single draw call
+Dynamic_Array<SDL_Rect> render_buffer_rects = {};
+Dynamic_Array<SDL_Vertex> render_buffer_vertices = {};
+
+void Render_Buffer::flush(SDL_Renderer *renderer)
+{
+    recording = false;
+
+    qsort(commands.data, commands.size, sizeof(commands.data[0]), compare_render_commands);
+
+    stats = {};
+    stats.commands = commands.size;
+
+    // NOTE: the state of SDL we have set so far. Nothing is known at the
+    // beginning of the flush.
+    SDL_Texture *current_texture = nullptr;
+    SDL_Texture *mod_texture = nullptr;
+    RGBA8 mod_color = {};
+    bool draw_state_known = false;
+    RGBA8 draw_color = {};
+    SDL_BlendMode current_blend = draw_blend;
+
+    const auto set_texture_mod = [&](SDL_Texture *texture, RGBA8 color) {
+        if (texture != mod_texture || !rgba8_equal(color, mod_color)) {
+            sec(SDL_SetTextureColorMod(texture, color.r, color.g, color.b));
+            sec(SDL_SetTextureAlphaMod(texture, color.a));
+            mod_texture = texture;
+            mod_color = color;
+            stats.state_changes += 1;
+        }
+    };
+
+    const auto set_draw_state = [&](RGBA8 color, SDL_BlendMode blend) {
+        if (!draw_state_known || blend != current_blend) {
+            sec(SDL_SetRenderDrawBlendMode(renderer, blend));
+            current_blend = blend;
+            stats.state_changes += 1;
+        }
+        if (!draw_state_known || !rgba8_equal(color, draw_color)) {
+            sec(SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a));
+            draw_color = color;
+            stats.state_changes += 1;
+        }
+        draw_state_known = true;
+    };
+
+    size_t i = 0;
+    while (i < commands.size) {
+        const auto command = commands.data[i];
+
+        if (command.texture != nullptr && command.texture != current_texture) {
+            current_texture = command.texture;
+            stats.texture_switches += 1;
+        }
+
+        // NOTE: how many commands are submitted by this draw call
+        size_t n = 1;
+
+        switch (command.kind) {
+        case Render_Command_Kind::Copy: {
+            set_texture_mod(command.texture, command.color);
+            sec(SDL_RenderCopyEx(renderer, command.texture,
+                                 &command.srcrect, &command.dstrect,
+                                 0.0, nullptr, command.flip));
+        } break;
+
+        case Render_Command_Kind::Geometry: {
+            render_buffer_vertices.clear();
+            size_t j = i;
+            for (; j < commands.size; ++j) {
+                const auto next = commands.data[j];
+                if (next.kind != Render_Command_Kind::Geometry ||
+                    next.layer != command.layer ||
+                    next.texture != command.texture) break;
+                render_buffer_vertices.concat(vertices.data + next.vertices_begin, next.vertices_count);
+            }
+            n = j - i;
+
+            set_texture_mod(command.texture, RGBA8 {255, 255, 255, 255});
+            sec(SDL_RenderGeometry(renderer, command.texture,
+                                   render_buffer_vertices.data,
+                                   (int) render_buffer_vertices.size,
+                                   nullptr, 0));
+        } break;
+
+        case Render_Command_Kind::Fill_Rect: {
+            render_buffer_rects.clear();
+            size_t j = i;
+            for (; j < commands.size; ++j) {
+                const auto next = commands.data[j];
+                if (next.kind != Render_Command_Kind::Fill_Rect ||
+                    next.layer != command.layer ||
+                    next.blend != command.blend ||
+                    !rgba8_equal(next.color, command.color)) break;
+                render_buffer_rects.push(next.dstrect);
+            }
+            n = j - i;
+
+            set_draw_state(command.color, command.blend);
+            sec(SDL_RenderFillRects(renderer,
+                                    render_buffer_rects.data,
+                                    (int) render_buffer_rects.size));
+        } break;
+
+        case Render_Command_Kind::Draw_Rect: {
+            set_draw_state(command.color, command.blend);
+            sec(SDL_RenderDrawRect(renderer, &command.dstrect));
+        } break;
+
+        case Render_Command_Kind::Line: {
+            set_draw_state(command.color, command.blend);
+            sec(SDL_RenderDrawLine(renderer,
+                                   command.dstrect.x, command.dstrect.y,
+                                   command.dstrect.w, command.dstrect.h));
+        } break;
+        }
+
+        stats.draw_calls += 1;
+        i += n;
+    }
+
+    if (draw_state_known && current_blend != draw_blend) {
+        sec(SDL_SetRenderDrawBlendMode(renderer, draw_blend));
+    }
+
+    commands.clear();
+    vertices.clear();
+}
+
+Render_Bake begin_bake(SDL_Renderer *renderer, SDL_Texture *target)
+{
+    assert(!render_buffer.baking);
+
+    Render_Bake bake = {};
+    bake.prev_target = SDL_GetRenderTarget(renderer);
+    bake.recording = render_buffer.recording;
+
+    render_buffer.recording = false;
+    render_buffer.baking = true;
+
+    sec(SDL_SetRenderTarget(renderer, target));
+    sec(SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0));
+    sec(SDL_RenderClear(renderer));
+
+    return bake;
+}
+
+void end_bake(SDL_Renderer *renderer, Render_Bake bake)
+{
+    assert(render_buffer.baking);
+
+    sec(SDL_SetRenderTarget(renderer, bake.prev_target));
+
+    render_buffer.baking = false;
+    render_buffer.recording = bake.recording;
+}
+
+void render_copy(SDL_Renderer *renderer, SDL_Texture *texture,
+                 const SDL_Rect *srcrect, const SDL_Rect *dstrect,
+                 SDL_RendererFlip flip, RGBA8 color)
+{
+    if (render_buffer.recording) {
+        Render_Command command = {};
+        command.kind = Render_Command_Kind::Copy;
+        command.texture = texture;
+        command.color = color;
+        command.srcrect = *srcrect;
+        command.dstrect = *dstrect;
+        command.flip = flip;
+        render_buffer.push(command);
+        return;
+    }
+
+    SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+    if (render_buffer.baking) {
+        sec(SDL_GetTextureBlendMode(texture, &blend));
+        sec(SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE));
+    }
+
+    sec(SDL_SetTextureColorMod(texture, color.r, color.g, color.b));
+    sec(SDL_SetTextureAlphaMod(texture, color.a));
+    sec(SDL_RenderCopyEx(renderer, texture, srcrect, dstrect, 0.0, nullptr, flip));
+
+    if (render_buffer.baking) {
+        sec(SDL_SetTextureBlendMode(texture, blend));
+    }
+}
+
+// NOTE: the color of the geometry comes from the vertices
+void render_geometry(SDL_Renderer *renderer, SDL_Texture *texture,
+                     const SDL_Vertex *vertices, size_t vertices_count)
+{
+    if (vertices_count == 0) return;
+
+    if (render_buffer.recording) {
+        Render_Command command = {};
+        command.kind = Render_Command_Kind::Geometry;
+        command.texture = texture;
+        command.vertices_begin = render_buffer.vertices.size;
+        command.vertices_count = vertices_count;
+        render_buffer.vertices.concat(vertices, vertices_count);
+        render_buffer.push(command);
+        return;
+    }
+
+    SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+    if (render_buffer.baking) {
+        sec(SDL_GetTextureBlendMode(texture, &blend));
+        sec(SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE));
+    }
+
+    sec(SDL_SetTextureColorMod(texture, 255, 255, 255));
+    sec(SDL_SetTextureAlphaMod(texture, 255));
+    sec(SDL_RenderGeometry(renderer, texture, vertices, (int) vertices_count, nullptr, 0));
+
+    if (render_buffer.baking) {
+        sec(SDL_SetTextureBlendMode(texture, blend));
+    }
+}
+
 void render_line(SDL_Renderer *renderer, Vec2f begin, Vec2f end, RGBA color)
 {
-    SDL_Color sdl_color = rgba_to_sdl(color);
-    sec(SDL_SetRenderDrawColor(renderer, sdl_color.r, sdl_color.g, sdl_color.b, sdl_color.a));
+    render_line(renderer, begin, end, rgba8(color));
+}
+
+void render_line(SDL_Renderer *renderer, Vec2f begin, Vec2f end, RGBA8 color)
+{
+    if (render_buffer.recording) {
+        Render_Command command = {};
+        command.kind = Render_Command_Kind::Line;
+        command.color = color;
+        command.dstrect = {
+            (int) floorf(begin.x), (int) floorf(begin.y),
+            (int) floorf(end.x),   (int) floorf(end.y)
+        };
+        render_buffer.push(command);
+        return;
+    }
+
+    sec(SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a));
     sec(SDL_RenderDrawLine(
             renderer,
             (int) floorf(begin.x), (int) floorf(begin.y),
@@ -12,13 +310,49 @@ void render_line(SDL_Renderer *renderer, Vec2f begin, Vec2f end, RGBA color)
 
 void fill_rect(SDL_Renderer *renderer, Rectf rectf, RGBA color)
 {
-    SDL_Color sdl_color = rgba_to_sdl(color);
-    sec(SDL_SetRenderDrawColor(renderer, sdl_color.r, sdl_color.g, sdl_color.b, sdl_color.a));
+    fill_rect(renderer, rectf, rgba8(color));
+}
+
+void fill_rect(SDL_Renderer *renderer, Rectf rectf, RGBA8 color)
+{
     SDL_Rect rect = {
         (int) floorf(rectf.x),
         (int) floorf(rectf.y),
         (int) floorf(rectf.w),
         (int) floorf(rectf.h),
     };
+
+    if (render_buffer.recording) {
+        Render_Command command = {};
+        command.kind = Render_Command_Kind::Fill_Rect;
+        command.color = color;
+        command.dstrect = rect;
+        render_buffer.push(command);
+        return;
+    }
+
+    sec(SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a));
     sec(SDL_RenderFillRect(renderer, &rect));
 }
+
+void draw_rect(SDL_Renderer *renderer, Rectf rectf, RGBA8 color)
+{
+    SDL_Rect rect = {
+        (int) floorf(rectf.x),
+        (int) floorf(rectf.y),
+        (int) floorf(rectf.w),
+        (int) floorf(rectf.h),
+    };
+
+    if (render_buffer.recording) {
+        Render_Command command = {};
+        command.kind = Render_Command_Kind::Draw_Rect;
+        command.color = color;
+        command.dstrect = rect;
+        render_buffer.push(command);
+        return;
+    }
+
+    sec(SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a));
+    sec(SDL_RenderDrawRect(renderer, &rect));
+}
@@ -1,7 +1,128 @@
 #ifndef _SOMETHING_RENDER_HPP
 #define _SOMETHING_RENDER_HPP
 
+// NOTE: the commands are submitted layer by layer in this order
+enum class Render_Layer
+{
+    Background = 0,
+    Debug_Bfs,
+    Grid,
+    Particles,
+    Entities,
+    Projectiles,
+    Items,
+    // NOTE: live bars and guns of the entities
+    Entity_Overlay,
+};
+
+// NOTE: Only the draws of the sortable layers are reordered by texture,
+// because they never overlap each other. The rest of the layers are
+// drawn in the recorded order (the background layers, the overlapping
+// entities and their flashes), and only the consecutive draws there
+// share the state.
+bool render_layer_is_sortable(Render_Layer layer);
+
+enum class Render_Command_Kind
+{
+    Copy = 0,
+    Geometry,
+    Fill_Rect,
+    Draw_Rect,
+    Line,
+};
+
+struct Render_Command
+{
+    Render_Layer layer;
+    Render_Command_Kind kind;
+    // NOTE: see Render_Buffer::pass
+    size_t pass;
+    // NOTE: position of the command in the buffer, keeps the sort stable
+    size_t order;
+
+    SDL_Texture *texture;
+    SDL_BlendMode blend;
+    // NOTE: color mod of the texture for Copy, draw color for the shapes
+    RGBA8 color;
+
+    // NOTE: Copy uses srcrect, dstrect and flip. Fill_Rect and Draw_Rect
+    // use dstrect. Line goes from (dstrect.x, dstrect.y) to (dstrect.w,
+    // dstrect.h).
+    SDL_Rect srcrect;
+    SDL_Rect dstrect;
+    SDL_RendererFlip flip;
+
+    // NOTE: Geometry only, range of Render_Buffer::vertices
+    size_t vertices_begin;
+    size_t vertices_count;
+};
+
+struct Render_Stats
+{
+    size_t commands;
+    size_t draw_calls;
+    size_t texture_switches;
+    size_t state_changes;
+};
+
+// NOTE: while the buffer is recording, the render functions below record
+// the draw calls instead of submitting them to SDL. flush() sorts the
+// commands by layer, and the commands of the sortable layers by pass and
+// texture (keeping the recorded order otherwise), and submits them in
+// batches. When the buffer is not recording the
+// render functions draw immediately.
+struct Render_Buffer
+{
+    bool recording;
+    // NOTE: see begin_bake()
+    bool baking;
+    Render_Layer layer;
+    // NOTE: In the sortable layers all of the draws of a pass are
+    // submitted before the draws of the next pass, no matter their
+    // textures. Used for the draws that must stay on top of the draws
+    // before them, like the masks of the sprites.
+    size_t pass;
+    SDL_BlendMode draw_blend;
+
+    Dynamic_Array<Render_Command> commands;
+    Dynamic_Array<SDL_Vertex> vertices;
+
+    // NOTE: stats of the last flush()
+    Render_Stats stats;
+
+    void begin(SDL_Renderer *renderer);
+    void push(Render_Command command);
+    void flush(SDL_Renderer *renderer);
+};
+
+Render_Buffer render_buffer = {};
+
+// NOTE: Baking is drawing into a render target texture that is cleared
+// to transparent and later drawn with SDL_BLENDMODE_BLEND. While baking
+// the textures are copied with SDL_BLENDMODE_NONE, so their straight
+// alpha ends up in the target as is. Blending them into the transparent
+// target would apply the alpha once, and drawing the target would apply
+// it once more. The draws of a single bake must not overlap.
+//
+// Baking is never recorded into the render buffer.
+struct Render_Bake
+{
+    SDL_Texture *prev_target;
+    bool recording;
+};
+
+Render_Bake begin_bake(SDL_Renderer *renderer, SDL_Texture *target);
+void end_bake(SDL_Renderer *renderer, Render_Bake bake);
+
+void render_copy(SDL_Renderer *renderer, SDL_Texture *texture,
+                 const SDL_Rect *srcrect, const SDL_Rect *dstrect,
+                 SDL_RendererFlip flip, RGBA8 color);
+void render_geometry(SDL_Renderer *renderer, SDL_Texture *texture,
+                     const SDL_Vertex *vertices, size_t vertices_count);
 void render_line(SDL_Renderer *renderer, Vec2f begin, Vec2f end, RGBA color);
+void render_line(SDL_Renderer *renderer, Vec2f begin, Vec2f end, RGBA8 color);
 void fill_rect(SDL_Renderer *renderer, Rectf rect, RGBA color);
+void fill_rect(SDL_Renderer *renderer, Rectf rect, RGBA8 color);
+void draw_rect(SDL_Renderer *renderer, Rectf rect, RGBA8 color);
 
 #endif // _SOMETHING_RENDER_HPP
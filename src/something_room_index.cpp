@@ -0,0 +1,105 @@
+#include "./something_room_index.hpp"
+
+// NOTE: the range of the cells overlapped by the rect, clamped to the index
+static Recti room_index_cells_of(Recti rect)
+{
+    const int x0 = clamp(rect.x / ROOM_INDEX_CELL_WIDTH, 0, ROOM_INDEX_COLS - 1);
+    const int y0 = clamp(rect.y / ROOM_INDEX_CELL_HEIGHT, 0, ROOM_INDEX_ROWS - 1);
+    const int x1 = clamp((rect.x + rect.w - 1) / ROOM_INDEX_CELL_WIDTH, 0, ROOM_INDEX_COLS - 1);
+    const int y1 = clamp((rect.y + rect.h - 1) / ROOM_INDEX_CELL_HEIGHT, 0, ROOM_INDEX_ROWS - 1);
+    return {x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+}
+
+static bool rooms_adjacent(Recti a, Recti b)
+{
+    // NOTE: negative gap means that the ranges overlap along the axis
+    const int gap_x = max(b.x - (a.x + a.w), a.x - (b.x + b.w));
+    const int gap_y = max(b.y - (a.y + a.h), a.y - (b.y + b.h));
+    return (0 <= gap_x && gap_x <= ROOM_ADJACENCY_GAP && gap_y < 0) ||
+           (0 <= gap_y && gap_y <= ROOM_ADJACENCY_GAP && gap_x < 0);
+}
+
+Room_Id Room_Index::add_room(Recti room)
+{
+    assert(rooms_count < ROOM_INDEX_CAPACITY);
+    assert(room.x >= 0 && room.y >= 0 && room.w > 0 && room.h > 0);
+
+    const Room_Id id = (Room_Id) rooms_count++;
+    rooms[id] = room;
+
+    // Neighbors //////////////////////////////
+    {
+        // NOTE: the gap tiles plus the first row of tiles of the neighbor
+        const int reach = ROOM_ADJACENCY_GAP + 1;
+        const Recti area = {
+            room.x - reach,
+            room.y - reach,
+            room.w + reach * 2,
+            room.h + reach * 2
+        };
+        const Recti area_cells = room_index_cells_of(area);
+
+        for (int y = area_cells.y; y < area_cells.y + area_cells.h; ++y) {
+            for (int x = area_cells.x; x < area_cells.x + area_cells.w; ++x) {
+                const auto cell = &cells[y][x];
+                for (size_t i = 0; i < cell->count; ++i) {
+                    const Room_Id other = cell->rooms[i];
+                    if (!rooms_adjacent(room, rooms[other])) continue;
+
+                    // NOTE: a room may be in several cells of the area
+                    bool known = false;
+                    for (size_t j = 0; j < neighbors_count[id] && !known; ++j) {
+                        known = neighbors[id][j] == other;
+                    }
+                    if (known) continue;
+
+                    assert(neighbors_count[id] < ROOM_NEIGHBORS_CAPACITY);
+                    assert(neighbors_count[other] < ROOM_NEIGHBORS_CAPACITY);
+                    neighbors[id][neighbors_count[id]++] = other;
+                    neighbors[other][neighbors_count[other]++] = id;
+                }
+            }
+        }
+    }
+
+    // Cells //////////////////////////////
+    {
+        const Recti room_cells = room_index_cells_of(room);
+        for (int y = room_cells.y; y < room_cells.y + room_cells.h; ++y) {
+            for (int x = room_cells.x; x < room_cells.x + room_cells.w; ++x) {
+                auto cell = &cells[y][x];
+                assert(cell->count < ROOM_INDEX_CELL_CAPACITY);
+                cell->rooms[cell->count++] = id;
+            }
+        }
+    }
+
+    return id;
+}
+
+Maybe<Room_Id> Room_Index::room_at_tile(Vec2i coord) const
+{
+    if (coord.x < 0 || coord.y < 0) return {};
+
+    const int x = coord.x / ROOM_INDEX_CELL_WIDTH;
+    const int y = coord.y / ROOM_INDEX_CELL_HEIGHT;
+    if (x >= ROOM_INDEX_COLS || y >= ROOM_INDEX_ROWS) return {};
+
+    // NOTE: the rooms are not supposed to overlap, but if they do the
+    // latest one wins
+    const auto cell = &cells[y][x];
+    for (size_t i = cell->count; i > 0; --i) {
+        const Room_Id id = cell->rooms[i - 1];
+        if (rect_contains_vec2(rooms[id], coord)) {
+            return {true, id};
+        }
+    }
+
+    return {};
+}
+
+Maybe<Room_Id> Room_Index::room_at_abs(Vec2f pos) const
+{
+    return room_at_tile(vec2((int) floorf(pos.x / TILE_SIZE),
+                             (int) floorf(pos.y / TILE_SIZE)));
+}
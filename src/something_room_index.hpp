@@ -0,0 +1,46 @@
+#ifndef SOMETHING_ROOM_INDEX_HPP_
+#define SOMETHING_ROOM_INDEX_HPP_
+
+const size_t ROOM_INDEX_CAPACITY = 200;
+// NOTE: the index cells are as big as a room, so a room-sized rectangle
+// overlaps at most 4 of them
+const int ROOM_INDEX_CELL_WIDTH = ROOM_WIDTH;
+const int ROOM_INDEX_CELL_HEIGHT = ROOM_HEIGHT;
+const int ROOM_INDEX_COLS = ((int) TILE_GRID_WIDTH + ROOM_INDEX_CELL_WIDTH - 1) / ROOM_INDEX_CELL_WIDTH;
+const int ROOM_INDEX_ROWS = ((int) TILE_GRID_HEIGHT + ROOM_INDEX_CELL_HEIGHT - 1) / ROOM_INDEX_CELL_HEIGHT;
+const size_t ROOM_INDEX_CELL_CAPACITY = 4;
+const size_t ROOM_NEIGHBORS_CAPACITY = 8;
+// NOTE: rooms that are at most this many tiles apart along one axis
+// and overlap along the other one are considered adjacent
+const int ROOM_ADJACENCY_GAP = 1;
+
+typedef uint16_t Room_Id;
+
+static_assert(ROOM_INDEX_CAPACITY <= UINT16_MAX, "Room_Id is too narrow for ROOM_INDEX_CAPACITY");
+
+struct Room_Index_Cell
+{
+    Room_Id rooms[ROOM_INDEX_CELL_CAPACITY];
+    size_t count;
+};
+
+// NOTE: maps tile coordinates to the rooms (camera locks) that contain
+// them through a coarse grid of room-sized cells, and keeps the graph
+// of the adjacent rooms. The ids are the indices of the rooms in the
+// order they were added.
+struct Room_Index
+{
+    Recti rooms[ROOM_INDEX_CAPACITY];
+    size_t rooms_count;
+
+    Room_Index_Cell cells[ROOM_INDEX_ROWS][ROOM_INDEX_COLS];
+
+    Room_Id neighbors[ROOM_INDEX_CAPACITY][ROOM_NEIGHBORS_CAPACITY];
+    size_t neighbors_count[ROOM_INDEX_CAPACITY];
+
+    Room_Id add_room(Recti room);
+    Maybe<Room_Id> room_at_tile(Vec2i coord) const;
+    Maybe<Room_Id> room_at_abs(Vec2f pos) const;
+};
+
+#endif  // SOMETHING_ROOM_INDEX_HPP_
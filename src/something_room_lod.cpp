@@ -0,0 +1,192 @@
+#include "./something_room_lod.hpp"
+
+// NOTE: the same as Tile_Grid::compute_variant() but for a room that
+// is not on the grid. Everything outside of the room is empty.
+static void room_lod_compute_variants(Room_Lod *lod)
+{
+    const auto is_empty = [&](int x, int y) {
+        if (x < 0 || x >= ROOM_WIDTH || y < 0 || y >= ROOM_HEIGHT) return true;
+        return !tile_props.collidable[lod->tiles[y][x]];
+    };
+
+    for (int y = 0; y < ROOM_HEIGHT; ++y) {
+        for (int x = 0; x < ROOM_WIDTH; ++x) {
+            Tile_Variant variant = 0;
+            if (!is_empty(x, y - 1)) variant |= TILE_VARIANT_UP;
+            if (!is_empty(x + 1, y)) variant |= TILE_VARIANT_RIGHT;
+            if (!is_empty(x, y + 1)) variant |= TILE_VARIANT_DOWN;
+            if (!is_empty(x - 1, y)) variant |= TILE_VARIANT_LEFT;
+            lod->variants[y][x] = variant;
+        }
+    }
+}
+
+static bool room_lod_is_stale(const Room_Lod *lod, const Tile_Grid *grid, Recti room)
+{
+    for (int dy = 0; dy < ROOM_HEIGHT; ++dy) {
+        if (memcmp(lod->tiles[dy], &grid->tiles[room.y + dy][room.x], sizeof(lod->tiles[dy])) != 0 ||
+            memcmp(lod->variants[dy], &grid->variants[room.y + dy][room.x], sizeof(lod->variants[dy])) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void room_lod_copy_from_grid(Room_Lod *lod, const Tile_Grid *grid, Recti room)
+{
+    for (int dy = 0; dy < ROOM_HEIGHT; ++dy) {
+        memcpy(lod->tiles[dy], &grid->tiles[room.y + dy][room.x], sizeof(lod->tiles[dy]));
+        memcpy(lod->variants[dy], &grid->variants[room.y + dy][room.x], sizeof(lod->variants[dy]));
+    }
+}
+
+static void room_lod_render_tiles(SDL_Renderer *renderer, Camera camera,
+                                  const Room_Lod *lod, Recti room, RGBA8 shade)
+{
+    for (int dy = 0; dy < ROOM_HEIGHT; ++dy) {
+        for (int dx = 0; dx < ROOM_WIDTH; ++dx) {
+            const auto sprite = tile_props.variant_textures[lod->tiles[dy][dx]][lod->variants[dy][dx]];
+            if (sprite.srcrect.w <= 0 || sprite.srcrect.h <= 0) continue;
+
+            const int x = room.x + dx;
+            const int y = room.y + dy;
+            const Vec2f p0 = camera.to_screen(vec2((float) x, (float) y) * TILE_SIZE);
+            const Vec2f p1 = camera.to_screen(vec2((float) (x + 1), (float) (y + 1)) * TILE_SIZE);
+            const Rectf dstrect = {
+                floorf(p0.x), floorf(p0.y),
+                floorf(p1.x) - floorf(p0.x), floorf(p1.y) - floorf(p0.y),
+            };
+
+            sprite.render(renderer, dstrect, SDL_FLIP_NONE, shade);
+        }
+    }
+}
+
+void Room_Lod_Cache::bake(SDL_Renderer *renderer, Room_Lod *lod)
+{
+    if (lod->texture == nullptr) {
+        lod->texture = sec(SDL_CreateTexture(renderer,
+                                             SDL_PIXELFORMAT_RGBA32,
+                                             SDL_TEXTUREACCESS_TARGET,
+                                             ROOM_WIDTH * ROOM_LOD_TILE_SIZE,
+                                             ROOM_HEIGHT * ROOM_LOD_TILE_SIZE));
+        sec(SDL_SetTextureBlendMode(lod->texture, SDL_BLENDMODE_BLEND));
+    }
+
+    // NOTE: the tiles don't overlap, so the room can be baked as is
+    const auto baking = begin_bake(renderer, lod->texture);
+
+    // NOTE: the tiles are scaled down a lot here, so they come from
+    // the smallest mips of the tileset
+    for (int y = 0; y < ROOM_HEIGHT; ++y) {
+        for (int x = 0; x < ROOM_WIDTH; ++x) {
+            const auto sprite = tile_props.variant_textures[lod->tiles[y][x]][lod->variants[y][x]];
+            if (sprite.srcrect.w <= 0 || sprite.srcrect.h <= 0) continue;
+
+            sprite.render(renderer, rect(vec2((float) (x * ROOM_LOD_TILE_SIZE),
+                                              (float) (y * ROOM_LOD_TILE_SIZE)),
+                                         (float) ROOM_LOD_TILE_SIZE,
+                                         (float) ROOM_LOD_TILE_SIZE));
+        }
+    }
+
+    end_bake(renderer, baking);
+
+    lod->baked = true;
+    stats.baked += 1;
+}
+
+void Room_Lod_Cache::render(SDL_Renderer *renderer, Camera camera,
+                            Tile_Grid *grid, const Room_Index *index,
+                            const Room_Streamer *streamer, Recti *lock)
+{
+    stats = {};
+
+    const Rectf view = camera.view_rect();
+
+    // NOTE: approximates the dimming that Tile_Grid::render() does
+    // with the masks by modulating the color of the whole room
+    const RGBA8 dim_color = rgba8(ROOM_NEIGHBOR_DIM_COLOR);
+    const float dim_alpha = (float) dim_color.a / 255.0f;
+    const RGBA8 dim_mod = {
+        (uint8_t) (255.0f * (1.0f - dim_alpha) + (float) dim_color.r * dim_alpha),
+        (uint8_t) (255.0f * (1.0f - dim_alpha) + (float) dim_color.g * dim_alpha),
+        (uint8_t) (255.0f * (1.0f - dim_alpha) + (float) dim_color.b * dim_alpha),
+        255
+    };
+
+    // NOTE: without a source the grid is the only place the rooms
+    // can come from
+    const bool has_source = streamer->source.count() > 0;
+
+    size_t bakes_left = ROOM_LOD_BAKES_PER_FRAME;
+    for (Room_Id id = 0; id < index->rooms_count; ++id) {
+        const Recti room = index->rooms[id];
+        assert(room.x >= 0 && room.x + ROOM_WIDTH <= (int) TILE_GRID_WIDTH);
+        assert(room.y >= 0 && room.y + ROOM_HEIGHT <= (int) TILE_GRID_HEIGHT);
+
+        const Rectf room_abs = rect_cast<float>(room) * TILE_SIZE;
+        if (!rects_overlap(view, room_abs)) continue;
+
+        Room_Lod *lod = &lods[id];
+        const bool on_grid = !has_source || streamer->states[id] == Room_Stream_State::Loaded;
+
+        if (on_grid) {
+            if (!lod->has_tiles || room_lod_is_stale(lod, grid, room)) {
+                room_lod_copy_from_grid(lod, grid, room);
+                lod->has_tiles = true;
+                lod->baked = false;
+            }
+        } else if (!lod->has_tiles) {
+            if (!streamer->source.decode(streamer->source_indices[id], lod->tiles)) continue;
+            room_lod_compute_variants(lod);
+            lod->has_tiles = true;
+            lod->baked = false;
+        }
+
+        if (!lod->baked && bakes_left > 0) {
+            bake(renderer, lod);
+            bakes_left -= 1;
+        }
+
+        const bool is_locked = lock && lock->x == room.x && lock->y == room.y;
+
+        if (!lod->baked) {
+            room_lod_render_tiles(renderer, camera, lod, room,
+                                  is_locked ? RGBA8 {0, 0, 0, 0} : dim_color);
+            stats.fallback += 1;
+            continue;
+        }
+
+        const Vec2f p0 = camera.to_screen(vec2(room_abs.x, room_abs.y));
+        const Vec2f p1 = camera.to_screen(vec2(room_abs.x + room_abs.w, room_abs.y + room_abs.h));
+        const SDL_Rect dstrect = {
+            (int) floorf(p0.x), (int) floorf(p0.y),
+            (int) floorf(p1.x) - (int) floorf(p0.x),
+            (int) floorf(p1.y) - (int) floorf(p0.y),
+        };
+
+        const SDL_Rect srcrect = {
+            0, 0,
+            ROOM_WIDTH * ROOM_LOD_TILE_SIZE,
+            ROOM_HEIGHT * ROOM_LOD_TILE_SIZE,
+        };
+
+        render_copy(renderer, lod->texture, &srcrect, &dstrect, SDL_FLIP_NONE,
+                    is_locked ? RGBA8 {255, 255, 255, 255} : dim_mod);
+        stats.drawn += 1;
+    }
+}
+
+void Room_Lod_Cache::invalidate()
+{
+    // NOTE: the tiles are still valid, only the textures have to be
+    // baked again
+    for (size_t i = 0; i < ROOM_INDEX_CAPACITY; ++i) {
+        if (lods[i].texture != nullptr) {
+            SDL_DestroyTexture(lods[i].texture);
+        }
+        lods[i].texture = nullptr;
+        lods[i].baked = false;
+    }
+}
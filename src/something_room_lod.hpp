@@ -0,0 +1,56 @@
+#ifndef SOMETHING_ROOM_LOD_HPP_
+#define SOMETHING_ROOM_LOD_HPP_
+
+// NOTE: size of a single tile in the baked textures of the rooms
+const int ROOM_LOD_TILE_SIZE = 8;
+// NOTE: baking a room is ROOM_WIDTH * ROOM_HEIGHT draw calls plus a
+// render target switch, so only this many rooms are baked per frame.
+// The rest are drawn tile by tile until they are baked on one of the
+// next frames.
+const size_t ROOM_LOD_BAKES_PER_FRAME = 8;
+
+// NOTE: a room pre-rendered into a single small texture together with
+// the tiles it was rendered from. `baked` is false while the texture
+// does not match the tiles yet.
+struct Room_Lod
+{
+    SDL_Texture *texture;
+    bool baked;
+    bool has_tiles;
+    Tile tiles[ROOM_HEIGHT][ROOM_WIDTH];
+    Tile_Variant variants[ROOM_HEIGHT][ROOM_WIDTH];
+};
+
+struct Room_Lod_Stats
+{
+    size_t drawn;
+    size_t baked;
+    // NOTE: the rooms drawn tile by tile because they were not baked yet
+    size_t fallback;
+};
+
+// NOTE: The level of detail path for the zoomed out camera. Every
+// visible room is drawn as one copy of its baked texture instead of
+// ROOM_WIDTH * ROOM_HEIGHT tiles. A room is baked again when its tiles
+// on the grid differ from the tiles it was baked from. The rooms that
+// the streamer has evicted from the grid keep their last tiles, and the
+// ones that were never on the grid are decoded straight from their
+// source. A room that is waiting for its bake is drawn tile by tile, so
+// no room is missing while the camera zooms out over the map.
+//
+// The ids of the rooms are the ids of Room_Index.
+struct Room_Lod_Cache
+{
+    Room_Lod lods[ROOM_INDEX_CAPACITY];
+    Room_Lod_Stats stats;
+
+    void render(SDL_Renderer *renderer, Camera camera,
+                Tile_Grid *grid, const Room_Index *index,
+                const Room_Streamer *streamer, Recti *lock);
+    void bake(SDL_Renderer *renderer, Room_Lod *lod);
+    // NOTE: must be called when the content of the render targets is lost
+    // (SDL_RENDER_TARGETS_RESET, SDL_RENDER_DEVICE_RESET)
+    void invalidate();
+};
+
+#endif  // SOMETHING_ROOM_LOD_HPP_
@@ -0,0 +1,246 @@
+#include "./something_room_streamer.hpp"
+
+const uint8_t ROOM_STREAMER_UNREACHED = UINT8_MAX;
+
+// NOTE: TILE_EMPTY is 0
+const Tile ROOM_STREAMER_EMPTY_ROOM[ROOM_HEIGHT][ROOM_WIDTH] = {};
+
+size_t Room_Source::count() const
+{
+    if (archive) {
+        return archive->header.rooms_count;
+    }
+    return files_count;
+}
+
+bool Room_Source::decode(size_t index, Tile room[ROOM_HEIGHT][ROOM_WIDTH]) const
+{
+    assert(index < count());
+    if (archive) {
+        return decode_archive_room(archive, index, room);
+    }
+    return decode_room_file(files[index].data, files[index].size, room);
+}
+
+// NOTE: breadth-first search over the adjacent rooms of the index. The
+// rooms that are further than max_distance steps away from `center`
+// stay ROOM_STREAMER_UNREACHED.
+static void room_streamer_distances(const Room_Index *index, Room_Id center, int max_distance,
+                                    uint8_t distances[ROOM_INDEX_CAPACITY])
+{
+    assert(max_distance < ROOM_STREAMER_UNREACHED);
+    memset(distances, ROOM_STREAMER_UNREACHED, ROOM_INDEX_CAPACITY * sizeof(distances[0]));
+
+    Queue<Room_Id, ROOM_INDEX_CAPACITY> queue = {};
+    distances[center] = 0;
+    queue.nq(center);
+
+    while (queue.count > 0) {
+        const Room_Id room = queue.dq();
+        if (distances[room] >= max_distance) continue;
+
+        for (size_t i = 0; i < index->neighbors_count[room]; ++i) {
+            const Room_Id neighbor = index->neighbors[room][i];
+            if (distances[neighbor] == ROOM_STREAMER_UNREACHED) {
+                distances[neighbor] = (uint8_t) (distances[room] + 1);
+                queue.nq(neighbor);
+            }
+        }
+    }
+}
+
+static int room_streamer_radius()
+{
+    return clamp(ROOM_STREAMING_RADIUS, 0, ROOM_STREAMER_UNREACHED - 2);
+}
+
+void Room_Streamer::set_room_source(Room_Id room, size_t source_index)
+{
+    assert(room < ROOM_INDEX_CAPACITY);
+    assert(source_index < source.count());
+    source_indices[room] = source_index;
+    states[room] = Room_Stream_State::Unloaded;
+}
+
+void Room_Streamer::start()
+{
+    assert(thread == nullptr);
+    SDL_AtomicSet(&quit, 0);
+    requests_sem = sec(SDL_CreateSemaphore(0));
+    thread = sec(SDL_CreateThread(room_streamer_thread, "room streamer", this));
+}
+
+void Room_Streamer::stop()
+{
+    if (thread == nullptr) return;
+
+    SDL_AtomicSet(&quit, 1);
+    sec(SDL_SemPost(requests_sem));
+    SDL_WaitThread(thread, NULL);
+    thread = nullptr;
+
+    SDL_DestroySemaphore(requests_sem);
+    requests_sem = nullptr;
+}
+
+void Room_Streamer::update(Tile_Grid *grid, const Room_Index *index, Vec2f player_pos)
+{
+    Room_Stream_Result result;
+    while (results.pop(&result)) {
+        assert(stats.pending > 0);
+        stats.pending -= 1;
+
+        // NOTE: the room could've been put on the grid synchronously
+        // while it was in flight
+        if (states[result.room] != Room_Stream_State::Loading) continue;
+
+        if (!result.ok) {
+            println(stderr, "Could not stream room ", result.room, " from source room ", source_indices[result.room]);
+            abort();
+        }
+
+        grid->load_room_from_tiles(result.tiles, rect_top_left(index->rooms[result.room]));
+        states[result.room] = Room_Stream_State::Loaded;
+        stats.resident += 1;
+        stats.loaded += 1;
+
+        // NOTE: the player could've left the radius of the room while it
+        // was in flight, in that case it must be evicted again
+        dirty = true;
+    }
+
+    if (disabled || thread == nullptr) return;
+
+    // NOTE: in between of the rooms the player is still considered to
+    // be in the last room they were in
+    const auto room = index->room_at_abs(player_pos);
+    if (room.has_value && room != center) {
+        center = room;
+        dirty = true;
+    }
+
+    if (!dirty || !center.has_value) return;
+    dirty = false;
+
+    const int radius = room_streamer_radius();
+    uint8_t distances[ROOM_INDEX_CAPACITY];
+    room_streamer_distances(index, center.unwrap, radius + 1, distances);
+
+    for (Room_Id id = 0; id < index->rooms_count; ++id) {
+        switch (states[id]) {
+        case Room_Stream_State::Unloaded: {
+            if (distances[id] > radius) break;
+
+            if (stats.pending >= ROOM_STREAMER_QUEUE_CAPACITY) {
+                // NOTE: try again on the next tick
+                dirty = true;
+                break;
+            }
+
+            const bool pushed = requests.push({id, source_indices[id]});
+            assert(pushed);
+            (void) pushed;
+            sec(SDL_SemPost(requests_sem));
+
+            states[id] = Room_Stream_State::Loading;
+            stats.pending += 1;
+        } break;
+
+        case Room_Stream_State::Loaded: {
+            if (distances[id] != ROOM_STREAMER_UNREACHED) break;
+
+            grid->load_room_from_tiles(ROOM_STREAMER_EMPTY_ROOM, rect_top_left(index->rooms[id]));
+            states[id] = Room_Stream_State::Unloaded;
+            stats.resident -= 1;
+            stats.evicted += 1;
+        } break;
+
+        case Room_Stream_State::Loading:
+            break;
+        }
+    }
+}
+
+bool Room_Streamer::is_resident(const Room_Index *index, Vec2f pos) const
+{
+    if (disabled || thread == nullptr) return true;
+
+    const auto room = index->room_at_abs(pos);
+    if (!room.has_value) return true;
+
+    return states[room.unwrap] == Room_Stream_State::Loaded;
+}
+
+void Room_Streamer::load_room_now(Tile_Grid *grid, const Room_Index *index, Room_Id room)
+{
+    assert(room < index->rooms_count);
+    if (states[room] == Room_Stream_State::Loaded) return;
+
+    Tile tiles[ROOM_HEIGHT][ROOM_WIDTH] = {};
+    if (!source.decode(source_indices[room], tiles)) {
+        println(stderr, "Could not load room ", room, " from source room ", source_indices[room]);
+        abort();
+    }
+
+    grid->load_room_from_tiles(tiles, rect_top_left(index->rooms[room]));
+    states[room] = Room_Stream_State::Loaded;
+    stats.resident += 1;
+    stats.loaded += 1;
+}
+
+void Room_Streamer::load_around(Tile_Grid *grid, const Room_Index *index, Vec2f pos)
+{
+    const auto room = index->room_at_abs(pos);
+    if (!room.has_value) return;
+
+    const int radius = room_streamer_radius();
+    uint8_t distances[ROOM_INDEX_CAPACITY];
+    room_streamer_distances(index, room.unwrap, radius, distances);
+
+    for (Room_Id id = 0; id < index->rooms_count; ++id) {
+        if (distances[id] <= radius) {
+            load_room_now(grid, index, id);
+        }
+    }
+
+    center = room;
+}
+
+void Room_Streamer::load_all(Tile_Grid *grid, const Room_Index *index)
+{
+    for (Room_Id id = 0; id < index->rooms_count; ++id) {
+        load_room_now(grid, index, id);
+    }
+}
+
+void Room_Streamer::disable(Tile_Grid *grid, const Room_Index *index)
+{
+    load_all(grid, index);
+    disabled = true;
+}
+
+int room_streamer_thread(void *data)
+{
+    PROFILE_THREAD(PROFILER_TRACK_STREAMING);
+
+    Room_Streamer *streamer = (Room_Streamer *) data;
+    Room_Stream_Result result = {};
+
+    while (true) {
+        sec(SDL_SemWait(streamer->requests_sem));
+        if (SDL_AtomicGet(&streamer->quit)) break;
+
+        Room_Stream_Request request = {};
+        if (!streamer->requests.pop(&request)) continue;
+
+        PROFILE_ZONE("decode room");
+        result.room = request.room;
+        result.ok = streamer->source.decode(request.source_index, result.tiles);
+
+        const bool pushed = streamer->results.push(result);
+        assert(pushed);
+        (void) pushed;
+    }
+
+    return 0;
+}
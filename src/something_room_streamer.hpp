@@ -0,0 +1,141 @@
+#ifndef SOMETHING_ROOM_STREAMER_HPP_
+#define SOMETHING_ROOM_STREAMER_HPP_
+
+// NOTE: must be a power of two so the indices of the queues stay
+// consistent when they wrap around
+const size_t ROOM_STREAMER_QUEUE_CAPACITY = 64;
+
+static_assert((ROOM_STREAMER_QUEUE_CAPACITY & (ROOM_STREAMER_QUEUE_CAPACITY - 1)) == 0,
+              "ROOM_STREAMER_QUEUE_CAPACITY must be a power of two");
+
+// NOTE: lock-free queue between exactly one producer thread and
+// exactly one consumer thread. `tail` is written only by the producer
+// and `head` only by the consumer, each of them after the item is in
+// place.
+template <typename T, size_t Capacity>
+struct Spsc_Queue
+{
+    T items[Capacity];
+    SDL_atomic_t head;
+    SDL_atomic_t tail;
+
+    bool push(const T &item)
+    {
+        const unsigned int tail_ = (unsigned int) SDL_AtomicGet(&tail);
+        const unsigned int head_ = (unsigned int) SDL_AtomicGet(&head);
+        if (tail_ - head_ >= Capacity) return false;
+        items[tail_ % Capacity] = item;
+        SDL_AtomicSet(&tail, (int) (tail_ + 1));
+        return true;
+    }
+
+    bool pop(T *item)
+    {
+        const unsigned int head_ = (unsigned int) SDL_AtomicGet(&head);
+        const unsigned int tail_ = (unsigned int) SDL_AtomicGet(&tail);
+        if (head_ == tail_) return false;
+        *item = items[head_ % Capacity];
+        SDL_AtomicSet(&head, (int) (head_ + 1));
+        return true;
+    }
+};
+
+// NOTE: where the rooms of the level are decoded from. Either a level
+// archive or the raw room files. The memory must stay mapped for as
+// long as the streamer is running.
+struct Room_Source
+{
+    const Level_Archive *archive;
+    const Mapped_File *files;
+    size_t files_count;
+
+    size_t count() const;
+    bool decode(size_t index, Tile room[ROOM_HEIGHT][ROOM_WIDTH]) const;
+};
+
+enum class Room_Stream_State
+{
+    Unloaded = 0,
+    Loading,
+    Loaded
+};
+
+struct Room_Stream_Request
+{
+    Room_Id room;
+    size_t source_index;
+};
+
+struct Room_Stream_Result
+{
+    Room_Id room;
+    bool ok;
+    Tile tiles[ROOM_HEIGHT][ROOM_WIDTH];
+};
+
+struct Room_Stream_Stats
+{
+    size_t resident;
+    size_t pending;
+    size_t loaded;
+    size_t evicted;
+};
+
+// NOTE: Keeps only the rooms around the player on the grid. The rooms
+// within ROOM_STREAMING_RADIUS steps of the room graph of Room_Index
+// are decoded by a background thread and placed on the grid by
+// update() at the beginning of a tick. The rooms further than
+// ROOM_STREAMING_RADIUS + 1 steps are cleared. The extra step keeps
+// the rooms on the border from being reloaded over and over while
+// the player is walking back and forth.
+//
+// The ids of the rooms are the ids of Room_Index.
+struct Room_Streamer
+{
+    Room_Source source;
+    size_t source_indices[ROOM_INDEX_CAPACITY];
+    Room_Stream_State states[ROOM_INDEX_CAPACITY];
+
+    // NOTE: requests are produced by the main thread and consumed by
+    // the streaming thread, results are the other way around. There
+    // are never more than ROOM_STREAMER_QUEUE_CAPACITY rooms in flight,
+    // so pushing a result never fails.
+    Spsc_Queue<Room_Stream_Request, ROOM_STREAMER_QUEUE_CAPACITY> requests;
+    Spsc_Queue<Room_Stream_Result, ROOM_STREAMER_QUEUE_CAPACITY> results;
+    SDL_sem *requests_sem;
+    SDL_Thread *thread;
+    SDL_atomic_t quit;
+
+    // NOTE: when disabled every room stays on the grid and is never
+    // evicted again
+    bool disabled;
+    Maybe<Room_Id> center;
+    bool dirty;
+    Room_Stream_Stats stats;
+
+    void set_room_source(Room_Id room, size_t source_index);
+
+    void start();
+    void stop();
+
+    // NOTE: must be called by the main thread at the tick boundary
+    void update(Tile_Grid *grid, const Room_Index *index, Vec2f player_pos);
+    // NOTE: synchronously puts the rooms around `pos` on the grid, so
+    // the player doesn't fall through the void on the first tick
+    void load_around(Tile_Grid *grid, const Room_Index *index, Vec2f pos);
+    // NOTE: synchronously puts all of the rooms that are not on the
+    // grid yet on the grid
+    void load_all(Tile_Grid *grid, const Room_Index *index);
+    void disable(Tile_Grid *grid, const Room_Index *index);
+
+    // NOTE: false when `pos` is in a room that is not on the grid right
+    // now. The objects there must not be simulated, otherwise they fall
+    // through the empty room.
+    bool is_resident(const Room_Index *index, Vec2f pos) const;
+
+    void load_room_now(Tile_Grid *grid, const Room_Index *index, Room_Id room);
+};
+
+int room_streamer_thread(void *data);
+
+#endif  // SOMETHING_ROOM_STREAMER_HPP_
@@ -81,6 +81,9 @@ Sample_S16 load_wav_as_sample_s16(const char *file_path)
 
 void sample_mixer_audio_callback(void *userdata, Uint8 *stream, int len)
 {
+    PROFILE_THREAD(PROFILER_TRACK_AUDIO);
+    PROFILE_ZONE("audio");
+
     Sample_Mixer *mixer = (Sample_Mixer *)userdata;
 
     int16_t *output = (int16_t *)stream;
@@ -15,50 +15,61 @@ Sprite sprite_from_texture_index(Texture_Index texture_index)
 void Sprite::render(SDL_Renderer *renderer,
                     Rectf destrect,
                     SDL_RendererFlip flip,
-                    RGBA shade) const
+                    RGBA8 shade) const
 {
     if (texture_index.unwrap < TEXTURE_COUNT) {
         SDL_Rect rect = rectf_for_sdl(destrect);
-        SDL_Color sdl_shade = rgba_to_sdl(shade);
 
-        sec(SDL_RenderCopyEx(
+        const size_t level = TEXTURE_MIPMAPS ? texture_mip_level(texture_index, srcrect, rect) : 0;
+        const SDL_Rect level_srcrect = {
+            srcrect.x >> level,
+            srcrect.y >> level,
+            srcrect.w >> level,
+            srcrect.h >> level,
+        };
+
+        render_copy(
+            renderer,
+            texture_mips[texture_index.unwrap][level],
+            &level_srcrect,
+            &rect,
+            flip,
+            RGBA8 {255, 255, 255, 255});
+
+        // NOTE: the masks are alpha blended, so a transparent shade
+        // does not change anything. The mask goes into the next pass so
+        // it stays on top of the sprite when the layer is sorted by
+        // texture.
+        if (shade.a > 0) {
+            render_buffer.pass += 1;
+            render_copy(
                 renderer,
-                textures[texture_index.unwrap],
-                &srcrect,
+                texture_mask_mips[texture_index.unwrap][level],
+                &level_srcrect,
                 &rect,
-                0.0,
-                nullptr,
-                flip));
-
-        sec(SDL_SetTextureColorMod(
-                texture_masks[texture_index.unwrap],
-                sdl_shade.r, sdl_shade.g, sdl_shade.b));
-        sec(SDL_SetTextureAlphaMod(texture_masks[texture_index.unwrap], sdl_shade.a));
-
-        sec(SDL_RenderCopyEx(
-                renderer,
-                texture_masks[texture_index.unwrap],
-                &srcrect,
-                &rect,
-                0.0,
-                nullptr,
-                flip));
+                flip,
+                shade);
+            render_buffer.pass -= 1;
+        }
     }
 }
 
 void Sprite::render(SDL_Renderer *renderer,
                     Vec2f pos,
                     SDL_RendererFlip flip,
-                    RGBA shade) const
+                    RGBA8 shade) const
+{
+    render(renderer, rect_centered_at(pos), flip, shade);
+}
+
+Rectf Sprite::rect_centered_at(Vec2f center) const
 {
-    const Rectf destrect = {
-        pos.x - (float) srcrect.w * 0.5f,
-        pos.y - (float) srcrect.h * 0.5f,
+    return {
+        center.x - (float) srcrect.w * 0.5f,
+        center.y - (float) srcrect.h * 0.5f,
         (float) srcrect.w,
         (float) srcrect.h
     };
-
-    render(renderer, destrect, flip, shade);
 }
 
 void Frame_Animat::reset()
@@ -69,7 +80,7 @@ void Frame_Animat::reset()
 void Frame_Animat::render(SDL_Renderer *renderer,
                           Rectf dstrect,
                           SDL_RendererFlip flip,
-                          RGBA shade) const
+                          RGBA8 shade) const
 {
     if (frame_count > 0) {
         frames[frame_current % frame_count].render(renderer, dstrect, flip, shade);
@@ -79,13 +90,21 @@ void Frame_Animat::render(SDL_Renderer *renderer,
 void Frame_Animat::render(SDL_Renderer *renderer,
                           Vec2f pos,
                           SDL_RendererFlip flip,
-                          RGBA shade) const
+                          RGBA8 shade) const
 {
     if (frame_count > 0) {
         frames[frame_current % frame_count].render(renderer, pos, flip, shade);
     }
 }
 
+Rectf Frame_Animat::rect_centered_at(Vec2f center) const
+{
+    if (frame_count > 0) {
+        return frames[frame_current % frame_count].rect_centered_at(center);
+    }
+    return rect(center, 0.0f, 0.0f);
+}
+
 void Frame_Animat::update(float dt)
 {
     if (dt < frame_cooldown) {
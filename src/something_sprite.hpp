@@ -9,11 +9,14 @@ struct Sprite
     void render(SDL_Renderer *renderer,
                 Rectf destrect,
                 SDL_RendererFlip flip = SDL_FLIP_NONE,
-                RGBA shade = {0, 0, 0, 0}) const;
+                RGBA8 shade = {0, 0, 0, 0}) const;
     void render(SDL_Renderer *renderer,
                 Vec2f pos,
                 SDL_RendererFlip flip = SDL_FLIP_NONE,
-                RGBA shade = {0, 0, 0, 0}) const;
+                RGBA8 shade = {0, 0, 0, 0}) const;
+
+    // NOTE: the rect of the size of srcrect centered at `center`
+    Rectf rect_centered_at(Vec2f center) const;
 };
 
 struct Frame_Animat
@@ -29,14 +32,16 @@ struct Frame_Animat
     void render(SDL_Renderer *renderer,
                 Rectf dstrect,
                 SDL_RendererFlip flip = SDL_FLIP_NONE,
-                RGBA shade = {0, 0, 0, 0}) const;
+                RGBA8 shade = {0, 0, 0, 0}) const;
 
     void render(SDL_Renderer *renderer,
                 Vec2f pos,
                 SDL_RendererFlip flip = SDL_FLIP_NONE,
-                RGBA shade = {0, 0, 0, 0}) const;
+                RGBA8 shade = {0, 0, 0, 0}) const;
 
     void update(float dt);
+
+    Rectf rect_centered_at(Vec2f center) const;
 };
 
 
@@ -4,26 +4,176 @@ void load_textures(SDL_Renderer *renderer)
 {
     for (size_t i = 0; i < TEXTURE_COUNT; ++i) {
         if (textures[i] == nullptr) {
-            surfaces[i] = load_png_file_as_surface(texture_files[i]);
-            textures[i] = sec(SDL_CreateTextureFromSurface(renderer, surfaces[i]));
+            decode_texture(i);
+            upload_texture(renderer, i);
+        }
+    }
+}
 
-            surface_masks[i] = load_png_file_as_surface(texture_files[i]);
+// NOTE: the mask keeps the alpha of the texture and makes the rest of
+// the pixel white. The pixels are a single contiguous run, so this
+// flat loop is vectorized by the compiler.
+void fill_texture_mask(const uint32_t *pixels, uint32_t *mask, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        mask[i] = pixels[i] | 0x00FFFFFF;
+    }
+}
 
-            sec(SDL_LockSurface(surface_masks[i]));
-            assert(surface_masks[i]->format->format == SDL_PIXELFORMAT_RGBA32);
-            for (int row = 0; row < surface_masks[i]->h; ++row) {
-                uint32_t *pixel_row = (uint32_t*) ((uint8_t *) surface_masks[i]->pixels + row * surface_masks[i]->pitch);
-                for (int col = 0; col < surface_masks[i]->w; ++col) {
-                    pixel_row[col] = pixel_row[col] | 0x00FFFFFF;
+static uint32_t *alloc_texture_pixels(size_t index, int width, int height)
+{
+    uint32_t *pixels = (uint32_t *) malloc((size_t) width * (size_t) height * sizeof(uint32_t));
+    if (pixels == NULL) {
+        println(stderr, "[ERROR] Could not allocate ", width, "x", height, " pixels for `", texture_files[index], "`");
+        abort();
+    }
+    return pixels;
+}
+
+static SDL_Surface *make_texture_mask(size_t index, const uint32_t *pixels, int width, int height)
+{
+    uint32_t *mask_pixels = alloc_texture_pixels(index, width, height);
+    fill_texture_mask(pixels, mask_pixels, (size_t) width * (size_t) height);
+    return surface_from_rgba32_pixels(mask_pixels, width, height);
+}
+
+// NOTE: Box filter of every 2x2 block of pixels. The colors are
+// weighted by their alpha, so the transparent pixels around a sprite
+// don't darken its edges. The last row and column of the odd sized
+// images are dropped.
+void downsample_texture_pixels(const uint32_t *src, int src_width, int src_height, uint32_t *dst)
+{
+    const int dst_width = src_width / 2;
+    const int dst_height = src_height / 2;
+
+    for (int y = 0; y < dst_height; ++y) {
+        const uint8_t *row0 = (const uint8_t *) (src + (2 * y) * src_width);
+        const uint8_t *row1 = (const uint8_t *) (src + (2 * y + 1) * src_width);
+        uint8_t *out = (uint8_t *) (dst + y * dst_width);
+
+        for (int x = 0; x < dst_width; ++x) {
+            const uint8_t *block[4] = {
+                row0 + 8 * x, row0 + 8 * x + 4,
+                row1 + 8 * x, row1 + 8 * x + 4,
+            };
+
+            uint32_t alpha = 0;
+            uint32_t color[3] = {};
+            for (size_t i = 0; i < 4; ++i) {
+                const uint32_t a = block[i][3];
+                alpha += a;
+                for (size_t c = 0; c < 3; ++c) {
+                    color[c] += block[i][c] * a;
                 }
             }
-            SDL_UnlockSurface(surface_masks[i]);
 
-            texture_masks[i] = sec(SDL_CreateTextureFromSurface(renderer, surface_masks[i]));
+            for (size_t c = 0; c < 3; ++c) {
+                out[4 * x + c] = alpha > 0 ? (uint8_t) ((color[c] + alpha / 2) / alpha) : 0;
+            }
+            out[4 * x + 3] = (uint8_t) ((alpha + 2) / 4);
         }
     }
 }
 
+void decode_texture(size_t index)
+{
+    set_texture_surface(index, load_png_file_as_surface(texture_files[index]));
+}
+
+void set_texture_surface(size_t index, SDL_Surface *surface)
+{
+    assert(index < TEXTURE_COUNT);
+    assert(surface->format->format == SDL_PIXELFORMAT_RGBA32);
+    assert(surface->pitch == surface->w * 4);
+    surfaces[index] = surface;
+    surface_masks[index] = make_texture_mask(index, (const uint32_t *) surface->pixels, surface->w, surface->h);
+
+    // NOTE: every level is downsampled from the previous one
+    texture_mips_count[index] = 1;
+    const uint32_t *pixels = (const uint32_t *) surface->pixels;
+    int width = surface->w;
+    int height = surface->h;
+    while (texture_mips_count[index] < TEXTURE_MIPS_CAPACITY && width >= 2 && height >= 2) {
+        const size_t level = texture_mips_count[index]++;
+
+        uint32_t *level_pixels = alloc_texture_pixels(index, width / 2, height / 2);
+        downsample_texture_pixels(pixels, width, height, level_pixels);
+        pixels = level_pixels;
+        width /= 2;
+        height /= 2;
+
+        surface_mips[index][level] = surface_from_rgba32_pixels(level_pixels, width, height);
+        surface_mask_mips[index][level] = make_texture_mask(index, level_pixels, width, height);
+    }
+}
+
+static void free_staging_surface(SDL_Surface **surface)
+{
+    void *pixels = (*surface)->pixels;
+    SDL_FreeSurface(*surface);
+    free(pixels);
+    *surface = nullptr;
+}
+
+void upload_texture(SDL_Renderer *renderer, size_t index)
+{
+    assert(index < TEXTURE_COUNT);
+    assert(surfaces[index] != nullptr);
+    assert(surface_masks[index] != nullptr);
+
+    textures[index] = sec(SDL_CreateTextureFromSurface(renderer, surfaces[index]));
+    texture_masks[index] = sec(SDL_CreateTextureFromSurface(renderer, surface_masks[index]));
+    texture_mips[index][0] = textures[index];
+    texture_mask_mips[index][0] = texture_masks[index];
+
+    // NOTE: nothing reads the masks and the mips on the CPU side
+    free_staging_surface(&surface_masks[index]);
+    for (size_t level = 1; level < texture_mips_count[index]; ++level) {
+        texture_mips[index][level] = sec(SDL_CreateTextureFromSurface(renderer, surface_mips[index][level]));
+        texture_mask_mips[index][level] = sec(SDL_CreateTextureFromSurface(renderer, surface_mask_mips[index][level]));
+        free_staging_surface(&surface_mips[index][level]);
+        free_staging_surface(&surface_mask_mips[index][level]);
+    }
+}
+
+size_t texture_mip_level(Texture_Index index, SDL_Rect srcrect, SDL_Rect dstrect)
+{
+    assert(index.unwrap < TEXTURE_COUNT);
+
+    const int dst_w = abs(dstrect.w);
+    const int dst_h = abs(dstrect.h);
+
+    size_t level = 0;
+    while (level + 1 < texture_mips_count[index.unwrap]) {
+        const int next = (int) level + 1;
+
+        // NOTE: the srcrect must land on the pixels of the level
+        // exactly, otherwise the neighbouring sprites of the
+        // spritesheet would bleed in
+        const int unaligned = (1 << next) - 1;
+        if ((srcrect.x | srcrect.y | srcrect.w | srcrect.h) & unaligned) break;
+
+        // NOTE: never pick a level that would have to be upscaled
+        if ((srcrect.w >> next) < dst_w || (srcrect.h >> next) < dst_h) break;
+
+        level = (size_t) next;
+    }
+
+    return level;
+}
+
+void release_texture_surfaces()
+{
+    for (size_t i = 0; i < TEXTURE_COUNT; ++i) {
+        if (surfaces[i] == nullptr) continue;
+
+        void *pixels = surfaces[i]->pixels;
+        SDL_FreeSurface(surfaces[i]);
+        stbi_image_free(pixels);
+        surfaces[i] = nullptr;
+    }
+}
+
 Texture_Index texture_index_by_name(String_View filename)
 {
     for (size_t i = 0; i < TEXTURE_COUNT; ++i) {
@@ -71,15 +221,18 @@ SDL_Surface *load_png_file_as_surface(const char *image_filename)
         abort();
     }
 
-    SDL_Surface* image_surface =
-        sec(SDL_CreateRGBSurfaceFrom(image_pixels,
-                                     (int) width,
-                                     (int) height,
-                                     32,
-                                     (int) width * 4,
-                                     0x000000FF,
-                                     0x0000FF00,
-                                     0x00FF0000,
-                                     0xFF000000));
-    return image_surface;
+    return surface_from_rgba32_pixels(image_pixels, width, height);
+}
+
+SDL_Surface *surface_from_rgba32_pixels(uint32_t *pixels, int width, int height)
+{
+    return sec(SDL_CreateRGBSurfaceFrom(pixels,
+                                        width,
+                                        height,
+                                        32,
+                                        width * 4,
+                                        0x000000FF,
+                                        0x0000FF00,
+                                        0x00FF0000,
+                                        0xFF000000));
 }
@@ -20,19 +20,52 @@ struct Texture_Index
     size_t unwrap;
 };
 
-// TODO(#113): add support for mipmaps for the texture cache
+// NOTE: Every texture has a chain of mips, each of them half the size
+// of the previous one. Level 0 is the texture itself. The sprites
+// that are drawn smaller than their srcrect use the smallest level
+// that is still at least as big as the destination, see
+// texture_mip_level().
+const size_t TEXTURE_MIPS_CAPACITY = 4;
 
 SDL_Texture *textures[TEXTURE_COUNT] = {};
+// NOTE: the decoded pixels of the textures. Only needed by
+// init_tile_palettes(), after that they can be dropped with
+// release_texture_surfaces().
 SDL_Surface *surfaces[TEXTURE_COUNT] = {};
 SDL_Texture *texture_masks[TEXTURE_COUNT] = {};
+// NOTE: derived from surfaces by decode_texture() and freed by
+// upload_texture() right after the mask is uploaded
 SDL_Surface *surface_masks[TEXTURE_COUNT] = {};
 
+SDL_Texture *texture_mips[TEXTURE_COUNT][TEXTURE_MIPS_CAPACITY] = {};
+SDL_Texture *texture_mask_mips[TEXTURE_COUNT][TEXTURE_MIPS_CAPACITY] = {};
+size_t texture_mips_count[TEXTURE_COUNT] = {};
+// NOTE: the levels above 0 built by decode_texture() and freed by
+// upload_texture() just like surface_masks
+SDL_Surface *surface_mips[TEXTURE_COUNT][TEXTURE_MIPS_CAPACITY] = {};
+SDL_Surface *surface_mask_mips[TEXTURE_COUNT][TEXTURE_MIPS_CAPACITY] = {};
+
 SDL_Surface *load_png_file_as_surface(const char *image_filename);
 SDL_Texture *load_texture_from_bmp_file(SDL_Renderer *renderer,
                                         const char *image_filepath,
                                         SDL_Color color_key);
 
 void load_textures(SDL_Renderer *renderer);
+// NOTE: load_textures() is decode_texture() followed by
+// upload_texture() for every texture. The decoding does not touch the
+// renderer, so it can be done by any thread. The uploading must be
+// done by the thread that owns the renderer.
+void decode_texture(size_t index);
+void upload_texture(SDL_Renderer *renderer, size_t index);
+// NOTE: the part of decode_texture() after the PNG is decoded. The
+// pixels of the surface are owned by the texture from now on and must
+// be freeable by stbi_image_free().
+void set_texture_surface(size_t index, SDL_Surface *surface);
+void fill_texture_mask(const uint32_t *pixels, uint32_t *mask, size_t count);
+// NOTE: `dst` must have room for (src_width / 2) * (src_height / 2) pixels
+void downsample_texture_pixels(const uint32_t *src, int src_width, int src_height, uint32_t *dst);
+size_t texture_mip_level(Texture_Index index, SDL_Rect srcrect, SDL_Rect dstrect);
+void release_texture_surfaces();
 Texture_Index texture_index_by_name(String_View filename);
 
 SDL_Texture *load_texture_from_bmp_file(SDL_Renderer *renderer,
@@ -40,5 +73,7 @@ SDL_Texture *load_texture_from_bmp_file(SDL_Renderer *renderer,
                                         SDL_Color color_key);
 
 SDL_Surface *load_png_file_as_surface(const char *image_filename);
+// NOTE: does not copy the pixels, they must outlive the surface
+SDL_Surface *surface_from_rgba32_pixels(uint32_t *pixels, int width, int height);
 
 #endif  // SOMETHING_TEXTURE_HPP_
@@ -1,3 +1,5 @@
+#include <sys/stat.h>
+
 #include "something_tile_grid.hpp"
 
 Vec2i Tile_Grid::abs_to_tile_coord(Vec2f pos)
@@ -26,6 +28,7 @@ void Tile_Grid::set_tile(Vec2i coord, Tile tile)
 {
     if (is_tile_coord_inbounds(coord)) {
         tiles[coord.y][coord.x] = tile;
+        update_variants(rect(coord, 1, 1));
     }
 }
 
@@ -33,12 +36,46 @@ void Tile_Grid::copy_tile(Vec2i coord_dst, Vec2i coord_src)
 {
     if (is_tile_coord_inbounds(coord_dst) && is_tile_coord_inbounds(coord_src)) {
         tiles[coord_dst.y][coord_dst.x] = tiles[coord_src.y][coord_src.x];
+        update_variants(rect(coord_dst, 1, 1));
+    }
+}
+
+Tile_Variant Tile_Grid::get_variant(Vec2i coord)
+{
+    if (is_tile_coord_inbounds(coord)) {
+        return variants[coord.y][coord.x];
+    }
+
+    return 0;
+}
+
+Tile_Variant Tile_Grid::compute_variant(Vec2i coord)
+{
+    Tile_Variant variant = 0;
+    if (!is_tile_empty_tile(vec2(coord.x, coord.y - 1))) variant |= TILE_VARIANT_UP;
+    if (!is_tile_empty_tile(vec2(coord.x + 1, coord.y))) variant |= TILE_VARIANT_RIGHT;
+    if (!is_tile_empty_tile(vec2(coord.x, coord.y + 1))) variant |= TILE_VARIANT_DOWN;
+    if (!is_tile_empty_tile(vec2(coord.x - 1, coord.y))) variant |= TILE_VARIANT_LEFT;
+    return variant;
+}
+
+void Tile_Grid::update_variants(Recti area)
+{
+    const int x0 = max(area.x - 1, 0);
+    const int y0 = max(area.y - 1, 0);
+    const int x1 = min(area.x + area.w + 1, (int) TILE_GRID_WIDTH);
+    const int y1 = min(area.y + area.h + 1, (int) TILE_GRID_HEIGHT);
+
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            variants[y][x] = compute_variant(vec2(x, y));
+        }
     }
 }
 
 bool Tile_Grid::is_tile_empty_tile(Vec2i coord)
 {
-    return !tile_defs[get_tile(coord)].is_collidable;
+    return !tile_props.collidable[get_tile(coord)];
 }
 
 bool Tile_Grid::is_tile_empty_abs(Vec2f pos)
@@ -58,30 +95,35 @@ Tile *Tile_Grid::tile_at_abs(Vec2f pos)
 
 void Tile_Grid::render(SDL_Renderer *renderer, Camera camera, Recti *lock)
 {
-    const Vec2i begin = abs_to_tile_coord(
-        camera.pos - vec2(SCREEN_WIDTH, SCREEN_HEIGHT) * 0.5f);
-    const Vec2i end = abs_to_tile_coord(
-        camera.pos + vec2(SCREEN_WIDTH, SCREEN_HEIGHT) * 0.5f);
+    const Rectf view = camera.view_rect();
+    const Vec2i begin = abs_to_tile_coord(vec2(view.x, view.y));
+    const Vec2i end = abs_to_tile_coord(vec2(view.x + view.w, view.y + view.h));
+
+    const RGBA8 dim_color = rgba8(ROOM_NEIGHBOR_DIM_COLOR);
 
     for (int y = begin.y; y <= end.y; ++y) {
         for (int x = begin.x; x <= end.x; ++x) {
             const auto coord = vec2(x, y);
-            const auto tile = get_tile(coord);
-            const auto dstrect = rect(
-                camera.to_screen(vec2((float) x, (float) y) * TILE_SIZE),
-                TILE_SIZE, TILE_SIZE);
+            const auto sprite = tile_props.variant_textures[get_tile(coord)][get_variant(coord)];
+            // NOTE: nothing to draw for the tiles without a sprite (TILE_EMPTY)
+            if (sprite.srcrect.w <= 0 || sprite.srcrect.h <= 0) continue;
+
+            // NOTE: the corners are snapped to the pixels, so the tiles
+            // don't have gaps between them when the camera is zoomed
+            const Vec2f p0 = camera.to_screen(vec2((float) x, (float) y) * TILE_SIZE);
+            const Vec2f p1 = camera.to_screen(vec2((float) (x + 1), (float) (y + 1)) * TILE_SIZE);
+            const Rectf dstrect = {
+                floorf(p0.x), floorf(p0.y),
+                floorf(p1.x) - floorf(p0.x), floorf(p1.y) - floorf(p0.y),
+            };
 
-            RGBA shade_color = ROOM_NEIGHBOR_DIM_COLOR;
+            RGBA8 shade_color = dim_color;
 
             if (lock && rect_contains_vec2(*lock, coord)) {
                 shade_color = {0, 0, 0, 0};
             }
 
-            if (is_tile_empty_tile(vec2(coord.x, coord.y - 1))) {
-                tile_defs[tile].top_texture.render(renderer, dstrect, SDL_FLIP_NONE, shade_color);
-            } else {
-                tile_defs[tile].bottom_texture.render(renderer, dstrect, SDL_FLIP_NONE, shade_color);
-            }
+            sprite.render(renderer, dstrect, SDL_FLIP_NONE, shade_color);
         }
     }
 }
@@ -192,15 +234,7 @@ Maybe<Vec2i> Tile_Grid::next_in_bfs(Vec2i dst, Recti *lock)
 void fill_rect(SDL_Renderer *renderer, Camera *camera,
                Rectf rectf, RGBA color)
 {
-    SDL_Color sdl_color = rgba_to_sdl(color);
-    sec(SDL_SetRenderDrawColor(
-            renderer,
-            sdl_color.r,
-            sdl_color.g,
-            sdl_color.b,
-            sdl_color.a));
-    SDL_Rect rect = rectf_for_sdl(camera->to_screen(rectf));
-    sec(SDL_RenderFillRect(renderer, &rect));
+    fill_rect(renderer, camera->to_screen(rectf), color);
 }
 
 void Tile_Grid::render_debug_bfs_overlay(SDL_Renderer *renderer, Camera *camera, Recti *lock)
@@ -237,40 +271,373 @@ bool Tile_Grid::a_sees_b(Vec2f a, Vec2f b)
     return true;
 }
 
+// NOTE: Walks the tiles crossed by the segment a -> b in order (DDA)
+// and returns the first collidable one, so nothing is skipped
+// regardless of how far apart a and b are.
+Maybe<Tile_Hit> Tile_Grid::trace_segment(Vec2f a, Vec2f b)
+{
+    Vec2i tile = abs_to_tile_coord(a);
+    if (!is_tile_empty_tile(tile)) {
+        return {true, {tile, 0.0f}};
+    }
+
+    const Vec2i end = abs_to_tile_coord(b);
+    const Vec2f d = b - a;
+
+    Vec2i step = {};
+    Vec2f t_max = {INFINITY, INFINITY};
+    Vec2f t_delta = {INFINITY, INFINITY};
+
+    if (d.x > 0.0f) {
+        step.x = 1;
+        t_max.x = ((float) (tile.x + 1) * TILE_SIZE - a.x) / d.x;
+        t_delta.x = TILE_SIZE / d.x;
+    } else if (d.x < 0.0f) {
+        step.x = -1;
+        t_max.x = ((float) tile.x * TILE_SIZE - a.x) / d.x;
+        t_delta.x = -TILE_SIZE / d.x;
+    }
+
+    if (d.y > 0.0f) {
+        step.y = 1;
+        t_max.y = ((float) (tile.y + 1) * TILE_SIZE - a.y) / d.y;
+        t_delta.y = TILE_SIZE / d.y;
+    } else if (d.y < 0.0f) {
+        step.y = -1;
+        t_max.y = ((float) tile.y * TILE_SIZE - a.y) / d.y;
+        t_delta.y = -TILE_SIZE / d.y;
+    }
+
+    const int steps_count = abs(end.x - tile.x) + abs(end.y - tile.y);
+    for (int i = 0; i < steps_count; ++i) {
+        float t = 0.0f;
+        if (t_max.x < t_max.y) {
+            t = t_max.x;
+            tile.x += step.x;
+            t_max.x += t_delta.x;
+        } else {
+            t = t_max.y;
+            tile.y += step.y;
+            t_max.y += t_delta.y;
+        }
+
+        if (!is_tile_empty_tile(tile)) {
+            return {true, {tile, clamp(t, 0.0f, 1.0f)}};
+        }
+    }
+
+    return {};
+}
+
 void Tile_Grid::load_from_file(const char *filepath)
 {
-    FILE *f = fopen(filepath, "rb");
-    if (f == NULL) {
+    auto file = map_file(filepath);
+    if (!file.has_value) {
         println(stderr, "Could not load from file `", filepath, "`: ", strerror(errno));
         abort();
     }
+    defer(unmap_file(file.unwrap));
+
+    assert(file.unwrap.size >= TILE_GRID_WIDTH * TILE_GRID_HEIGHT * sizeof(Room_File_Tile));
+    const Room_File_Tile *file_tiles = (const Room_File_Tile *) file.unwrap.data;
+    for (size_t y = 0; y < TILE_GRID_HEIGHT; ++y) {
+        for (size_t x = 0; x < TILE_GRID_WIDTH; ++x) {
+            const Room_File_Tile file_tile = file_tiles[y * TILE_GRID_WIDTH + x];
+            assert(file_tile < TILE_COUNT);
+            tiles[y][x] = (Tile) file_tile;
+        }
+    }
 
-    size_t n = fread(tiles, sizeof(Tile), TILE_GRID_WIDTH * TILE_GRID_HEIGHT, f);
-    assert(n == TILE_GRID_WIDTH * TILE_GRID_HEIGHT);
-
-    fclose(f);
+    update_variants(rect(vec2(0, 0), (int) TILE_GRID_WIDTH, (int) TILE_GRID_HEIGHT));
 }
 
 void Tile_Grid::load_room_from_file(const char *filepath, Vec2i coord)
 {
-    Tile tmp[ROOM_HEIGHT][ROOM_WIDTH] = {};
-
-    FILE *f = fopen(filepath, "rb");
-    if (f == NULL) {
+    auto file = map_file(filepath);
+    if (!file.has_value) {
         println(stderr, "Could not load from file `", filepath, "`: ", strerror(errno));
         abort();
     }
+    defer(unmap_file(file.unwrap));
+
+    load_room_from_memory(file.unwrap.data, file.unwrap.size, coord);
+}
+
+// NOTE: `data` is in the raw room file format. Every Room_File_Tile is
+// converted to Tile while it's placed on the grid.
+void Tile_Grid::load_room_from_memory(const char *data, size_t size, Vec2i coord)
+{
+    assert(size >= ROOM_HEIGHT * ROOM_WIDTH * sizeof(Room_File_Tile));
+    (void) size;
+
+    const Room_File_Tile *file_tiles = (const Room_File_Tile *) data;
 
-    size_t n = fread(tmp, sizeof(Tile), ROOM_WIDTH * ROOM_HEIGHT, f);
-    assert(n == ROOM_WIDTH * ROOM_HEIGHT);
+    for (int dy = 0; dy < ROOM_HEIGHT; ++dy) {
+        const int y = coord.y + dy;
+        if (y < 0 || y >= (int) TILE_GRID_HEIGHT) continue;
+
+        // NOTE: the part of the row that is inside of the grid
+        const int x0 = max(coord.x, 0);
+        const int x1 = min(coord.x + ROOM_WIDTH, (int) TILE_GRID_WIDTH);
+
+        const Room_File_Tile *row = file_tiles + dy * ROOM_WIDTH;
+        for (int x = x0; x < x1; ++x) {
+            const Room_File_Tile file_tile = row[x - coord.x];
+            assert(file_tile < TILE_COUNT);
+            tiles[y][x] = (Tile) file_tile;
+        }
+    }
+
+    update_variants(rect(coord, ROOM_WIDTH, ROOM_HEIGHT));
+}
+
+// NOTE: copies the rows of the room straight into the grid
+void Tile_Grid::load_room_from_tiles(const Tile room[ROOM_HEIGHT][ROOM_WIDTH], Vec2i coord)
+{
+    for (int dy = 0; dy < ROOM_HEIGHT; ++dy) {
+        const int y = coord.y + dy;
+        if (y < 0 || y >= (int) TILE_GRID_HEIGHT) continue;
 
-    for (size_t dy = 0; dy < ROOM_HEIGHT; ++dy) {
-        for (size_t dx = 0; dx < ROOM_WIDTH; ++dx) {
-            size_t x = coord.x + dx;
-            size_t y = coord.y + dy;
-            if (x < (size_t) TILE_GRID_WIDTH && y < (size_t) TILE_GRID_HEIGHT) {
-                tiles[y][x] = tmp[dy][dx];
+        // NOTE: the part of the row that is inside of the grid
+        const int x0 = max(coord.x, 0);
+        const int x1 = min(coord.x + ROOM_WIDTH, (int) TILE_GRID_WIDTH);
+        if (x0 >= x1) continue;
+
+        memcpy(&tiles[y][x0], &room[dy][x0 - coord.x], (size_t) (x1 - x0) * sizeof(Tile));
+    }
+
+    update_variants(rect(coord, ROOM_WIDTH, ROOM_HEIGHT));
+}
+
+bool Tile_Grid::load_room_from_archive(const Level_Archive *archive, size_t room_index, Vec2i coord)
+{
+    Tile room[ROOM_HEIGHT][ROOM_WIDTH] = {};
+    if (!decode_archive_room(archive, room_index, room)) {
+        return false;
+    }
+
+    load_room_from_tiles(room, coord);
+    return true;
+}
+
+bool Tile_Grid::save_rooms_to_archive(const char *filepath, const Recti *rooms, size_t rooms_count)
+{
+    Dynamic_Array<uint8_t> packed = {};
+    defer(packed.release());
+    packed.reserve(rooms_count * ROOM_WIDTH * ROOM_HEIGHT);
+
+    for (size_t i = 0; i < rooms_count; ++i) {
+        for (int dy = 0; dy < ROOM_HEIGHT; ++dy) {
+            for (int dx = 0; dx < ROOM_WIDTH; ++dx) {
+                packed.push((uint8_t) get_tile(vec2(rooms[i].x + dx, rooms[i].y + dy)));
             }
         }
     }
+
+    return save_level_archive(filepath, ROOM_WIDTH, ROOM_HEIGHT, packed.data, rooms_count);
+}
+
+bool decode_archive_room(const Level_Archive *archive, size_t room_index, Tile room[ROOM_HEIGHT][ROOM_WIDTH])
+{
+    if (archive->header.room_width != ROOM_WIDTH || archive->header.room_height != ROOM_HEIGHT) {
+        return false;
+    }
+
+    uint8_t packed[ROOM_HEIGHT * ROOM_WIDTH] = {};
+    if (!archive->decode_room(room_index, packed)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < ROOM_HEIGHT * ROOM_WIDTH; ++i) {
+        if (packed[i] >= TILE_COUNT) return false;
+        room[i / ROOM_WIDTH][i % ROOM_WIDTH] = (Tile) packed[i];
+    }
+
+    return true;
+}
+
+bool decode_room_file(const char *data, size_t size, Tile room[ROOM_HEIGHT][ROOM_WIDTH])
+{
+    if (size < ROOM_HEIGHT * ROOM_WIDTH * sizeof(Room_File_Tile)) {
+        return false;
+    }
+
+    const Room_File_Tile *file_tiles = (const Room_File_Tile *) data;
+    for (size_t i = 0; i < ROOM_HEIGHT * ROOM_WIDTH; ++i) {
+        if (file_tiles[i] >= TILE_COUNT) return false;
+        room[i / ROOM_WIDTH][i % ROOM_WIDTH] = (Tile) file_tiles[i];
+    }
+
+    return true;
+}
+
+Dynamic_Array<Mapped_File> map_room_files(Dynamic_Array<Dynamic_Array<char>> room_files)
+{
+    Dynamic_Array<Mapped_File> rooms = {};
+    rooms.reserve(room_files.size);
+
+    for (size_t i = 0; i < room_files.size; ++i) {
+        auto file = map_file(room_files.data[i].data);
+        if (!file.has_value) {
+            println(stderr, "Could not load from file `", room_files.data[i].data, "`: ", strerror(errno));
+            abort();
+        }
+        rooms.push(file.unwrap);
+    }
+
+    return rooms;
+}
+
+void unmap_room_files(Dynamic_Array<Mapped_File> *rooms)
+{
+    for (size_t i = 0; i < rooms->size; ++i) {
+        unmap_file(rooms->data[i]);
+    }
+    rooms->release();
+}
+
+bool is_rooms_archive_stale(const char *archive_path, const char *room_dir_path)
+{
+    DIR *rooms_dir = opendir(room_dir_path);
+    if (rooms_dir == NULL) return false;
+    defer(closedir(rooms_dir));
+
+    struct stat archive_stat = {};
+    if (stat(archive_path, &archive_stat) < 0) return false;
+
+    for (struct dirent *d = readdir(rooms_dir);
+         d != NULL;
+         d = readdir(rooms_dir))
+    {
+        if (*d->d_name == '.') continue;
+
+        char room_file_path[256];
+        snprintf(room_file_path, sizeof(room_file_path), "%s%s", room_dir_path, d->d_name);
+
+        struct stat room_stat = {};
+        if (stat(room_file_path, &room_stat) < 0) continue;
+        if (room_stat.st_mtime > archive_stat.st_mtime) return true;
+    }
+
+    return false;
+}
+
+Dynamic_Array<Dynamic_Array<char>> load_room_files_from_dir(const char *room_dir_path)
+{
+    Dynamic_Array<Dynamic_Array<char>> room_files = {};
+
+    DIR *rooms_dir = opendir(room_dir_path);
+    defer(closedir(rooms_dir));
+    if (rooms_dir == NULL) {
+        println(stderr, "Can't open asset folder: ", room_dir_path);
+        abort();
+    }
+
+    for (struct dirent *d = readdir(rooms_dir);
+         d != NULL;
+         d = readdir(rooms_dir))
+    {
+        if (*d->d_name == '.') continue;
+        const size_t room_dir_path_len = strlen(room_dir_path);
+        const size_t name_len = strlen(d->d_name);
+
+        Dynamic_Array<char> room_file = {};
+        room_file.reserve(room_dir_path_len + name_len + 1);
+        room_file.concat(room_dir_path, room_dir_path_len);
+        room_file.concat(d->d_name, name_len);
+        room_file.push('\0');
+        room_files.push(room_file);
+    }
+
+    return room_files;
+}
+
+void init_tile_defs(Texture_Index tileset_texture)
+{
+    // TODO(#119): move tiles srcrect dimention to config.vars
+    //   That may require add a new type to the config file.
+    //   Might be a good opportunity to simplify adding new types to the system.
+    tile_defs[TILE_WALL].top_texture = {
+        {120, 128, 16, 16},
+        tileset_texture
+    };
+    tile_defs[TILE_WALL].bottom_texture = {
+        {120, 128 + 16, 16, 16},
+        tileset_texture
+    };
+    tile_defs[TILE_DESTROYABLE_0].top_texture = {
+        {208, 176, 16, 16},
+        tileset_texture,
+    };
+    tile_defs[TILE_DESTROYABLE_0].bottom_texture = tile_defs[TILE_DESTROYABLE_0].top_texture;
+    tile_defs[TILE_DESTROYABLE_1].top_texture = {
+        {208 + 16, 176, 16, 16},
+        tileset_texture,
+    };
+    tile_defs[TILE_DESTROYABLE_1].bottom_texture = tile_defs[TILE_DESTROYABLE_1].top_texture;
+
+    tile_defs[TILE_DESTROYABLE_2].top_texture = {
+        {208, 176 + 16, 16, 16},
+        tileset_texture,
+    };
+    tile_defs[TILE_DESTROYABLE_2].bottom_texture = tile_defs[TILE_DESTROYABLE_2].top_texture;
+
+    tile_defs[TILE_DESTROYABLE_3].top_texture = {
+        {208 + 16, 176 + 16, 16, 16},
+        tileset_texture,
+    };
+    tile_defs[TILE_DESTROYABLE_3].bottom_texture = tile_defs[TILE_DESTROYABLE_3].top_texture;
+
+    init_tile_palettes();
+    init_tile_props();
+}
+
+// NOTE: requires the textures to be loaded
+void init_tile_palettes()
+{
+    for (size_t tile = 0; tile < TILE_COUNT; ++tile) {
+        auto def = &tile_defs[tile];
+        def->palette_size = 0;
+
+        const auto sprite = def->top_texture;
+        if (sprite.srcrect.w <= 0 || sprite.srcrect.h <= 0) continue;
+
+        const auto surface = surfaces[sprite.texture_index.unwrap];
+        assert(surface != nullptr);
+
+        // NOTE: if the sprite is wider than the palette we pick the
+        // pixels evenly along the row
+        const int step = max(sprite.srcrect.w / (int) TILE_PALETTE_CAPACITY, 1);
+
+        sec(SDL_LockSurface(surface));
+        assert(surface->format->format == SDL_PIXELFORMAT_RGBA32);
+        const Uint32 *row = (Uint32*) ((uint8_t *) surface->pixels + sprite.srcrect.y * surface->pitch) + sprite.srcrect.x;
+        for (int x = 0;
+             x < sprite.srcrect.w && def->palette_size < TILE_PALETTE_CAPACITY;
+             x += step)
+        {
+            SDL_Color color = {};
+            SDL_GetRGBA(row[x], surface->format, &color.r, &color.g, &color.b, &color.a);
+            if (color.a == 0) continue;
+            def->palette[def->palette_size++] = sdl_to_rgba(color).to_hsla();
+        }
+        SDL_UnlockSurface(surface);
+    }
+}
+
+void init_tile_props()
+{
+    for (size_t tile = 0; tile < TILE_COUNT; ++tile) {
+        tile_props.collidable[tile] = tile_defs[tile].is_collidable;
+        tile_props.hit_tile[tile]   = tile_defs[tile].hit_tile;
+
+        // NOTE: the tileset only distinguishes the tiles that have
+        // something on top of them for now
+        for (size_t variant = 0; variant < TILE_VARIANT_COUNT; ++variant) {
+            tile_props.variant_textures[tile][variant] =
+                (variant & TILE_VARIANT_UP) ?
+                tile_defs[tile].bottom_texture :
+                tile_defs[tile].top_texture;
+        }
+    }
 }
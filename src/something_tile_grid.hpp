@@ -1,7 +1,18 @@
 #ifndef TILE_GRID_HPP_
 #define TILE_GRID_HPP_
 
-typedef uint32_t Tile;
+// NOTE: the tile grid is TILE_GRID_WIDTH * TILE_GRID_HEIGHT of these,
+// so keep it as narrow as possible. Can be overridden with
+// -DSOMETHING_TILE_TYPE=uint16_t if we ever need more than 256 tiles.
+#ifndef SOMETHING_TILE_TYPE
+#define SOMETHING_TILE_TYPE uint8_t
+#endif
+
+typedef SOMETHING_TILE_TYPE Tile;
+
+// NOTE: the format of the raw room files (./assets/rooms/*.bin). It is
+// independent from Tile so the files stay the same when Tile changes.
+typedef uint32_t Room_File_Tile;
 
 const Tile TILE_EMPTY         = 0;
 const Tile TILE_WALL          = 1;
@@ -11,31 +22,72 @@ const Tile TILE_DESTROYABLE_2 = 4;
 const Tile TILE_DESTROYABLE_3 = 5;
 const Tile TILE_COUNT         = 6;
 
+static_assert((Tile) (TILE_COUNT - 1) == TILE_COUNT - 1,
+              "Tile is too narrow for TILE_COUNT");
+
 const size_t TILE_GRID_WIDTH = 4096;
 const size_t TILE_GRID_HEIGHT = 4096;
 
+const size_t TILE_PALETTE_CAPACITY = 16;
+
+// NOTE: 4-neighbour autotiling. Every tile of the grid caches a bitmask
+// of its collidable neighbours, which selects the sprite of the tile.
+typedef uint8_t Tile_Variant;
+
+const Tile_Variant TILE_VARIANT_UP    = 1 << 0;
+const Tile_Variant TILE_VARIANT_RIGHT = 1 << 1;
+const Tile_Variant TILE_VARIANT_DOWN  = 1 << 2;
+const Tile_Variant TILE_VARIANT_LEFT  = 1 << 3;
+const size_t TILE_VARIANT_COUNT       = 16;
+
 struct Tile_Def
 {
     bool is_collidable;
+    // NOTE: what the tile turns into when it's hit by a projectile
+    Tile hit_tile;
     Sprite top_texture;
     Sprite bottom_texture;
+
+    // NOTE: colors of the opaque pixels of the top row of
+    // top_texture. Built once by init_tile_defs() so the particles
+    // don't have to lock the surface to pick a color.
+    HSLA palette[TILE_PALETTE_CAPACITY];
+    size_t palette_size;
 };
 
 Tile_Def tile_defs[TILE_COUNT] = {
-    {false, {}, {}},                          // TILE_EMPTY
-    {true, {}, {}},                           // TILE_WALL
-    {true, {}, {}},                           // TILE_DESTROYABLE_0
-    {true, {}, {}},                           // TILE_DESTROYABLE_1
-    {true, {}, {}},                           // TILE_DESTROYABLE_2
-    {true, {}, {}},                           // TILE_DESTROYABLE_3
+    {false, TILE_EMPTY, {}, {}, {}, 0},                         // TILE_EMPTY
+    {true, TILE_WALL, {}, {}, {}, 0},                           // TILE_WALL
+    {true, TILE_DESTROYABLE_1, {}, {}, {}, 0},                  // TILE_DESTROYABLE_0
+    {true, TILE_DESTROYABLE_2, {}, {}, {}, 0},                  // TILE_DESTROYABLE_1
+    {true, TILE_DESTROYABLE_3, {}, {}, {}, 0},                  // TILE_DESTROYABLE_2
+    {true, TILE_EMPTY, {}, {}, {}, 0},                          // TILE_DESTROYABLE_3
 };
 
+// NOTE: the per-tile properties that are looked up for every tile on
+// the hot paths (collision, rendering, projectiles) as a struct of
+// arrays indexed by Tile. Derived from tile_defs by init_tile_props(),
+// so edit tile_defs, not this.
+struct Tile_Props
+{
+    bool collidable[TILE_COUNT];
+    Tile hit_tile[TILE_COUNT];
+    Sprite variant_textures[TILE_COUNT][TILE_VARIANT_COUNT];
+};
+
+Tile_Props tile_props = {};
+
 const float TILE_SIZE = 128.0f * 0.5f;
 const float TILE_SIZE_SQR = TILE_SIZE * TILE_SIZE;
 
 const int ROOM_WIDTH  = 10 * 2;
 const int ROOM_HEIGHT = 10 * 2;
 
+// NOTE: built by the level_packer from ./assets/rooms/*.bin. When it's
+// missing or older than any of the room files the game falls back to
+// the raw room files.
+const char *const ROOMS_ARCHIVE_FILE_PATH = "./assets/rooms.pack";
+
 template <typename T, size_t Capacity>
 struct Queue
 {
@@ -77,12 +129,27 @@ struct Queue
 
 using Room_Queue = Queue<Vec2i, ROOM_WIDTH * ROOM_HEIGHT>;
 
+struct Tile_Hit
+{
+    Vec2i coord;
+    // NOTE: parameter along the traced segment, 0.0f is the beginning
+    // and 1.0f is the end of the segment
+    float t;
+};
+
 struct Tile_Grid
 {
     Tile tiles[TILE_GRID_HEIGHT][TILE_GRID_WIDTH];
+    // NOTE: must be kept in sync with `tiles` through update_variants().
+    // Everything that modifies the tiles in this file does that already.
+    Tile_Variant variants[TILE_GRID_HEIGHT][TILE_GRID_WIDTH];
 
     void load_from_file(const char *filepath);
     void load_room_from_file(const char *filepath, Vec2i coord);
+    void load_room_from_memory(const char *data, size_t size, Vec2i coord);
+    void load_room_from_tiles(const Tile room[ROOM_HEIGHT][ROOM_WIDTH], Vec2i coord);
+    bool load_room_from_archive(const Level_Archive *archive, size_t room_index, Vec2i coord);
+    bool save_rooms_to_archive(const char *filepath, const Recti *rooms, size_t rooms_count);
 
     void render(SDL_Renderer *renderer, Camera camera, Recti *lock);
     void resolve_point_collision(Vec2f *origin);
@@ -92,6 +159,12 @@ struct Tile_Grid
     void set_tile(Vec2i coord, Tile tile);
     void copy_tile(Vec2i coord_dst, Vec2i coord_src);
 
+    Tile_Variant get_variant(Vec2i coord);
+    Tile_Variant compute_variant(Vec2i coord);
+    // NOTE: recomputes the variants of the tiles of the area and of the
+    // tiles around it
+    void update_variants(Recti area);
+
     bool is_tile_coord_inbounds(Vec2i coord);
     bool is_tile_empty_tile(Vec2i coord);
     bool is_tile_empty_abs(Vec2f pos);
@@ -102,6 +175,25 @@ struct Tile_Grid
     Maybe<Vec2i> next_in_bfs(Vec2i dst0, Recti *lock);
     void render_debug_bfs_overlay(SDL_Renderer *renderer, Camera *camera, Recti *lock);
     bool a_sees_b(Vec2f a, Vec2f b);
+    Maybe<Tile_Hit> trace_segment(Vec2f a, Vec2f b);
 };
 
+// NOTE: decode a single room without touching the grid, so they can be
+// called from any thread
+bool decode_archive_room(const Level_Archive *archive, size_t room_index, Tile room[ROOM_HEIGHT][ROOM_WIDTH]);
+bool decode_room_file(const char *data, size_t size, Tile room[ROOM_HEIGHT][ROOM_WIDTH]);
+
+Dynamic_Array<Dynamic_Array<char>> load_room_files_from_dir(const char *room_dir_path);
+// NOTE: true when any of the room files in `room_dir_path` was modified
+// after the archive was built, e.g. by the save_room command. A missing
+// folder never makes the archive stale.
+bool is_rooms_archive_stale(const char *archive_path, const char *room_dir_path);
+// NOTE: maps every room file once so the rooms can be placed on the
+// grid as many times as needed without touching the files again
+Dynamic_Array<Mapped_File> map_room_files(Dynamic_Array<Dynamic_Array<char>> room_files);
+void unmap_room_files(Dynamic_Array<Mapped_File> *rooms);
+void init_tile_defs(Texture_Index tileset_texture);
+void init_tile_palettes();
+void init_tile_props();
+
 #endif  // TILE_GRID_HPP_
@@ -2,6 +2,7 @@
 
 static void render_tooltip(SDL_Renderer *renderer,
                            Bitmap_Font font,
+                           Text_Texture *tooltip_texture,
                            String_View tooltip,
                            Vec2f position)
 {
@@ -23,7 +24,8 @@ static void render_tooltip(SDL_Renderer *renderer,
             tooltip_background_color.b,
             tooltip_background_color.a));
     sec(SDL_RenderFillRect(renderer, &tooltip_rect));
-    font.render(renderer, position + padding, size, TOOLTIP_FOREGROUND_COLOR, tooltip);
+    font.render_cached(renderer, tooltip_texture, position + padding, size,
+                       rgba8(TOOLTIP_FOREGROUND_COLOR), tooltip);
 }
 
 
@@ -77,7 +79,7 @@ void Toolbar::render(SDL_Renderer *renderer, Bitmap_Font font)
     }
 
     if (hovered_button.has_value) {
-        render_tooltip(renderer, font,
+        render_tooltip(renderer, font, &tooltip_texture,
                        buttons[hovered_button.unwrap].tooltip,
                        tooltip_position);
     }
@@ -16,6 +16,7 @@ struct Toolbar
     size_t active_button;
     Maybe<size_t> hovered_button;
     Vec2f tooltip_position;
+    Text_Texture tooltip_texture;
 
     void render(SDL_Renderer *renderer, Bitmap_Font font);
     bool handle_click_at(Vec2f position);